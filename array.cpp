@@ -1,144 +1,200 @@
 #include "array.h"
 
-template <class T>
-Array<T>::Array(int length)
+template <class T, class Storage>
+Array<T, Storage>::Array(int length) : store(length)
 {
-    array = new T *[length]();
     this->length = length;
 }
-template <class T>
-Array<T>::Array(Array<T> &copy)
+template <class T, class Storage>
+Array<T, Storage>::Array(Storage &&store) : store(std::move(store))
 {
-    array = new T *[copy.length]();
-    this->length = copy.length;
-
-    for (int i = 0; i < length; i++)
-    {
-        if (copy[i])
-            array[i] = new T(*copy[i]);
-    }
+    this->length = this->store.capacity();
 }
-template <class T>
-void Array<T>::deleteAll()
+template <class T, class Storage>
+template <class Other>
+Array<T, Storage>::Array(const Array<T, Other> &copy) : store(copy.getLength())
 {
-    for (int i = 0; i < length; i++)
+    this->length = copy.getLength();
+    for (int i = copy.nextOccupied(0); i != -1; i = copy.nextOccupied(i + 1))
     {
-        if (array[i])
-            delete array[i];
+        store.construct(i, *copy[i]);
     }
 }
+template <class T, class Storage>
+Array<T, Storage>::Array(const Array<T, Storage> &copy) : store(copy.store)
+{
+    this->length = copy.length;
+}
+template <class T, class Storage>
+Array<T, Storage>::Array(Array<T, Storage> &&other) : store(std::move(other.store))
+{
+    this->length = other.length;
+    other.length = 0;
+}
+template <class T, class Storage>
+void Array<T, Storage>::deleteAll()
+{
+    store.destroyAll();
+}
 
-template <class T>
-Array<T>::~Array()
+template <class T, class Storage>
+Array<T, Storage>::~Array()
 {
-    deleteAll();
-    delete[] array;
 }
 
-template <class T>
-void Array<T>::increaseSizeBy(int increaseBy)
+template <class T, class Storage>
+void Array<T, Storage>::increaseSizeBy(int increaseBy)
 {
     if (increaseBy > 0)
     {
         int newLength = length + increaseBy;
-        T **n_array = new T *[newLength]();
-
-        for (int i = 0; i < length; i++)
-        {
-            n_array[i] = new T(*array[i]); //  uses copy constructor
-        }
-
-        deleteAll();
-        delete[] array;
-
-        array = n_array;
+        if (newLength > store.capacity())
+            grow(newLength);
         length = newLength;
     }
     else
         throw out_of_range("Array cannot have its size increased by negative number");
 }
 
-template <class T>
-void Array<T>::setLength(int newLength)
+template <class T, class Storage>
+void Array<T, Storage>::setLength(int newLength)
 {
     // will delete all data inside the array
     if (newLength > 0)
     {
-        deleteAll();
-        delete[] array;
-        array = new T[newLength];
-        for (int i = 0; i < newLength; i++)
-        {
-            array[i] = NULL;
-        }
-
+        store.destroyAll();
+        if (newLength > store.capacity())
+            store.resize(newLength);
         length = newLength;
     }
     else
         throw out_of_range("Array length must be greater than 0");
 }
 
-template <class T>
-T *Array<T>::getIndex(int i)
+template <class T, class Storage>
+void Array<T, Storage>::reserve(int capacity)
 {
-    if (i >= 0 && i < length)
-    {
-        return array[i];
-    }
-    else
+    // only ever grows, the length stays the same
+    if (capacity > store.capacity())
+        store.resize(capacity);
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::compact()
+{
+    // moves the items down over the empty slots, keeping their order, and returns how many there are
+    int filled = 0;
+    for (int i = store.nextOccupied(0); i != -1; i = store.nextOccupied(i + 1))
     {
-        throw out_of_range("Array index cannot be less than 0 or greater than length");
+        if (i != filled)
+        {
+            store.construct(filled, std::move(*store.writableSlot(i)));
+            store.destroy(i);
+        }
+        filled++;
     }
+
+    return filled;
+}
+
+template <class T, class Storage>
+void Array<T, Storage>::grow(int minCapacity)
+{
+    // doubling keeps appending amortized O(1)
+    int newCapacity = store.capacity() * 2;
+    if (newCapacity < 4)
+        newCapacity = 4;
+    if (newCapacity < minCapacity)
+        newCapacity = minCapacity;
+
+    store.resize(newCapacity);
 }
-template <class T>
-T *Array<T>::operator[](int i)
+
+template <class T, class Storage>
+T *Array<T, Storage>::getIndex(int i)
 {
     if (i >= 0 && i < length)
     {
-        return array[i];
+        return store.writableSlot(i);
     }
     else
     {
         throw out_of_range("Array index cannot be less than 0 or greater than length");
     }
 }
-template <class T>
-const T *Array<T>::operator[](int i) const
+template <class T, class Storage>
+T *Array<T, Storage>::operator[](int i)
 {
-    if (i >= 0 && i < length)
+    if (ARRAY_CHECKED && (i < 0 || i >= length))
     {
-        return array[i];
+        throw out_of_range("Array index cannot be less than 0 or greater than length");
     }
-    else
+
+    return store.slot(i);
+}
+template <class T, class Storage>
+const T *Array<T, Storage>::operator[](int i) const
+{
+    if (ARRAY_CHECKED && (i < 0 || i >= length))
     {
         throw out_of_range("Array index cannot be less than 0 or greater than length");
     }
+
+    return store.slot(i);
 }
 
-template <class T>
-Array<T> &Array<T>::operator=(const Array<T> &rhs)
+template <class T, class Storage>
+typename Array<T, Storage>::iterator Array<T, Storage>::begin()
+{
+    return iterator(&store, 0);
+}
+template <class T, class Storage>
+typename Array<T, Storage>::iterator Array<T, Storage>::end()
+{
+    return iterator(&store, length);
+}
+template <class T, class Storage>
+typename Array<T, Storage>::const_iterator Array<T, Storage>::begin() const
+{
+    return const_iterator(&store, 0);
+}
+template <class T, class Storage>
+typename Array<T, Storage>::const_iterator Array<T, Storage>::end() const
+{
+    return const_iterator(&store, length);
+}
+
+template <class T, class Storage>
+Array<T, Storage> &Array<T, Storage>::operator=(const Array<T, Storage> &rhs)
 {
     if (this == &rhs)
     {
         return *this;
     }
 
-    deleteAll();
-    delete[] array;
-
+    store = rhs.store;
     this->length = rhs.length;
-    array = new T *[length];
 
-    for (int i = 0; i < rhs.length; i++)
+    return *this;
+}
+
+template <class T, class Storage>
+Array<T, Storage> &Array<T, Storage>::operator=(Array<T, Storage> &&rhs)
+{
+    if (this == &rhs)
     {
-        array[i] = new T(*rhs[i]);
+        return *this;
     }
 
+    store = std::move(rhs.store);
+    this->length = rhs.length;
+    rhs.length = 0;
+
     return *this;
 }
 
-template <class T>
-bool Array<T>::operator==(const Array<T> &rhs)
+template <class T, class Storage>
+bool Array<T, Storage>::operator==(const Array<T, Storage> &rhs) const
 {
     if (length != rhs.length)
     {
@@ -146,69 +202,210 @@ bool Array<T>::operator==(const Array<T> &rhs)
         return false;
     }
 
-    for (int i = 0; i < rhs.length; i++)
+    return firstMismatch(rhs) == -1;
+}
+
+template <class T, class Storage>
+bool Array<T, Storage>::operator!=(const Array<T, Storage> &rhs) const
+{
+    return !(*this == rhs);
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::firstMismatch(const Array<T, Storage> &rhs) const
+{
+    // -1 when the arrays are equal, otherwise the first index where they differ
+    int shared = length < rhs.length ? length : rhs.length;
+    typedef integral_constant<bool, Storage::CONTIGUOUS && is_trivially_copyable<T>::value> FastPath;
+
+    int i = firstMismatch(rhs, shared, FastPath());
+    if (i == -1 && length != rhs.length)
+        return shared;
+
+    return i;
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::firstMismatch(const Array<T, Storage> &rhs, int shared, false_type) const
+{
+    for (int i = 0; i < shared; i++)
+    {
+        const T *lhsItem = store.slot(i);
+        const T *rhsItem = rhs.store.slot(i);
+
+        // two empty slots are equal, an empty and a filled slot are not
+        if (!lhsItem || !rhsItem)
+        {
+            if (lhsItem != rhsItem)
+                return i;
+        }
+        else if (*lhsItem != *rhsItem)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::firstMismatch(const Array<T, Storage> &rhs, int shared, true_type) const
+{
+    // works through the occupancy bitmaps 64 slots at a time, full words are compared as one block
+    typedef integral_constant<bool, is_integral<T>::value || is_enum<T>::value || is_pointer<T>::value> Bitwise;
+    const T *lhsData = store.data();
+    const T *rhsData = rhs.store.data();
+
+    for (int base = 0; base < shared; base += 64)
     {
+        int count = shared - base < 64 ? shared - base : 64;
+        uint64_t inRange = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+        uint64_t lhsBits = store.getOccupancy().getWord(base >> 6) & inRange;
+        uint64_t rhsBits = rhs.store.getOccupancy().getWord(base >> 6) & inRange;
+
+        // only the slots before the first occupancy difference can hold an earlier mismatch
+        uint64_t differ = lhsBits ^ rhsBits;
+        int limit = differ ? __builtin_ctzll(differ) : count;
 
-        if (*array[i] != *rhs[i])
+        if ((lhsBits & rhsBits) == inRange)
         {
-            return false;
+            int i = firstMismatchInBlock(lhsData + base, rhsData + base, limit, Bitwise());
+            if (i != -1)
+                return base + i;
         }
+        else
+        {
+            uint64_t check = lhsBits & rhsBits;
+            if (limit < 64)
+                check &= (uint64_t(1) << limit) - 1;
+
+            while (check)
+            {
+                int i = base + __builtin_ctzll(check);
+                if (lhsData[i] != rhsData[i])
+                    return i;
+                check &= check - 1;
+            }
+        }
+
+        if (differ)
+            return base + limit;
     }
 
-    return true;
+    return -1;
 }
 
-template <class T>
-void Array<T>::insertNewItem(T &newItem)
+template <class T, class Storage>
+int Array<T, Storage>::firstMismatchInBlock(const T *lhs, const T *rhs, int count, false_type)
 {
-    bool foundSpace = false;
-    for (int i = 0; i < length; i++)
+    // branch free chunks so the compiler can vectorize the comparisons
+    const int CHUNK = 16;
+    int i = 0;
+    for (; i + CHUNK <= count; i += CHUNK)
     {
-        if (array[i] == NULL)
+        bool differ = false;
+        for (int j = 0; j < CHUNK; j++)
         {
-            array[i] = new T(newItem);
-            foundSpace = true;
-            break;
+            differ |= lhs[i + j] != rhs[i + j];
         }
+        if (differ)
+            break;
     }
 
-    if (foundSpace)
-        return;
-    else
+    for (; i < count; i++)
     {
-        increaseSizeBy(1);
-        array[length - 1] = new T(newItem);
+        if (lhs[i] != rhs[i])
+            return i;
     }
+
+    return -1;
 }
-template <class T>
-void Array<T>::insert(T item)
+
+template <class T, class Storage>
+int Array<T, Storage>::firstMismatchInBlock(const T *lhs, const T *rhs, int count, true_type)
 {
-    T itemIn(item);
-    insertNewItem(itemIn);
+    // equal bytes means equal values for these types, memcmp does the vector work
+    if (memcmp(lhs, rhs, count * sizeof(T)) == 0)
+        return -1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (lhs[i] != rhs[i])
+            return i;
+    }
+
+    return -1;
 }
 
-template <class T>
-int Array<T>::getLength() const
+template <class T, class Storage>
+void Array<T, Storage>::insertNewItem(const T &newItem)
 {
-    return length;
+    emplace(newItem);
+}
+template <class T, class Storage>
+void Array<T, Storage>::insertNewItem(T &&newItem)
+{
+    emplace(std::move(newItem));
+}
+template <class T, class Storage>
+void Array<T, Storage>::insert(T item)
+{
+    emplace(std::move(item));
 }
 
-template <class T>
-string to_string(Array<T> array)
+template <class T, class Storage>
+template <class... Args>
+T *Array<T, Storage>::emplace(Args &&...args)
 {
-    string obj = "[ ";
-    for (int i = 0; i < array.getLength(); i++)
+    // builds the item straight inside the first empty slot
+    int i = store.firstEmpty(length);
+
+    if (i == -1)
     {
-        if (array[i])
+        if (length == store.capacity())
         {
-            obj += to_string(*array[i]);
+            // args may refer to an item in this array, so build it before growing moves the items
+            T item(std::forward<Args>(args)...);
+            increaseSizeBy(1);
+            store.construct(length - 1, std::move(item));
+            return store.slot(length - 1);
         }
-        else
-            obj += "NULL";
-        if (i != array.getLength() - 1)
-            obj += ", ";
+
+        increaseSizeBy(1);
+        i = length - 1;
     }
 
-    obj += " ]";
-    return obj;
+    store.construct(i, std::forward<Args>(args)...);
+    return store.slot(i);
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::getLength() const
+{
+    return length;
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::getCapacity() const
+{
+    return store.capacity();
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::countOccupied() const
+{
+    return store.countOccupied();
+}
+
+template <class T, class Storage>
+const Storage &Array<T, Storage>::getStorage() const
+{
+    return store;
+}
+
+template <class T, class Storage>
+int Array<T, Storage>::nextOccupied(int from) const
+{
+    // use as for (int i = arr.nextOccupied(0); i != -1; i = arr.nextOccupied(i + 1))
+    return store.nextOccupied(from);
 }
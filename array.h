@@ -3,39 +3,113 @@
 
 #include <stdexcept>
 #include <string>
+#include <cstring>
+#include <type_traits>
+#include "arrayStorage.h"
 using namespace std;
-template <class T>
+
+// [] and iterators check their index while ARRAY_CHECKED is 1, release builds (-DNDEBUG) skip the checks
+// getIndex always checks
+#ifndef ARRAY_CHECKED
+#ifdef NDEBUG
+#define ARRAY_CHECKED 0
+#else
+#define ARRAY_CHECKED 1
+#endif
+#endif
+
+#include "arrayIterator.h"
+
+/*
+Storage picks the memory layout of the slots (see arrayStorage.h)
+PointerStorage<T> allocates every item on its own
+PointerStorage<T, SlabPool<T>> allocates the items from slabs that are reused
+ContiguousStorage<T> keeps the items inline in one buffer
+SmallStorage<T, N> keeps up to N items inside the array itself and only allocates past that
+SharedStorage<T> lets copies share one buffer until one of them changes
+[] and iterators read a shared or mapped buffer in place, an item is changed through getIndex
+*/
+template <class T, class Storage = PointerStorage<T>>
 
 class Array
 {
 public:
+    typedef ArrayIterator<T, Storage, T> iterator;
+    typedef ArrayIterator<T, Storage, const T> const_iterator;
+
     Array(int length);
-    Array(Array<T> &copy);
+    // takes over a storage that is already filled, every slot of it is part of the array
+    Array(Storage &&store);
+    // copies the items of an array with another storage into the same slots
+    template <class Other>
+    Array(const Array<T, Other> &copy);
+    Array(const Array<T, Storage> &copy);
+    Array(Array<T, Storage> &&other);
     ~Array();
 
     void deleteAll();
     void increaseSizeBy(int increaseBy);
     void setLength(int length);
 
+    // the pointer may be used to change the item, a shared or mapped storage is copied first
     T *getIndex(int i);
     T *operator[](int i);
     const T *operator[](int i) const;
 
-    Array<T> &operator=(const Array<T> &rhs);
-    bool operator==(const Array<T> &rhs);
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    Array<T, Storage> &operator=(const Array<T, Storage> &rhs);
+    Array<T, Storage> &operator=(Array<T, Storage> &&rhs);
+    bool operator==(const Array<T, Storage> &rhs) const;
+    bool operator!=(const Array<T, Storage> &rhs) const;
+    int firstMismatch(const Array<T, Storage> &rhs) const;
 
     int getLength() const;
-    void insertNewItem(T &newItem);
+    int getCapacity() const;
+    int countOccupied() const;
+    int nextOccupied(int from) const;
+    // read only view of the storage policy, e.g. to ask a MappedStorage whether it is still mapped
+    const Storage &getStorage() const;
+    void reserve(int capacity);
+    int compact();
+    void insertNewItem(const T &newItem);
+    void insertNewItem(T &&newItem);
     void insert(T item);
+    template <class... Args>
+    T *emplace(Args &&...args);
 
 private:
-    T **array;
+    void grow(int minCapacity);
+
+    int firstMismatch(const Array<T, Storage> &rhs, int shared, false_type fastPath) const;
+    int firstMismatch(const Array<T, Storage> &rhs, int shared, true_type fastPath) const;
+    static int firstMismatchInBlock(const T *lhs, const T *rhs, int count, false_type bitwise);
+    static int firstMismatchInBlock(const T *lhs, const T *rhs, int count, true_type bitwise);
+
+    Storage store;
     int length;
+    // slots between length and the capacity of the store are always empty
 };
 
 template <class T>
-string to_string(Array<T> array);
+using ContiguousArray = Array<T, ContiguousStorage<T>>;
+
+template <class T>
+using PooledArray = Array<T, PointerStorage<T, SlabPool<T>>>;
+
+template <class T>
+using SharedArray = Array<T, SharedStorage<T>>;
+
+template <class T, int N = 4>
+using SmallArray = Array<T, SmallStorage<T, N>>;
+
+template <class T, class Storage>
+string to_string(const Array<T, Storage> &array);
 
 #include "array.cpp"
+#include "arraySerializer.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,341 @@
+#include "arrayAlgorithms.h"
+
+// ############################ Parallel code ############################
+inline int &Parallel::threadCount()
+{
+    static int threads = 0;
+    return threads;
+}
+
+inline int &Parallel::serialThreshold()
+{
+    static int items = 16384;
+    return items;
+}
+
+inline int Parallel::getThreadCount()
+{
+    if (threadCount() > 0)
+        return threadCount();
+
+    int cores = thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+inline void Parallel::setThreadCount(int threads)
+{
+    threadCount() = threads > 0 ? threads : 0;
+}
+
+inline int Parallel::getSerialThreshold()
+{
+    return serialThreshold();
+}
+
+inline void Parallel::setSerialThreshold(int items)
+{
+    serialThreshold() = items > 1 ? items : 1;
+}
+
+template <class Task>
+void Parallel::forEachTask(int tasks, Task task)
+{
+    if (tasks <= 1)
+    {
+        if (tasks == 1)
+            task(0);
+        return;
+    }
+
+    vector<thread> workers;
+    vector<exception_ptr> errors(tasks);
+    workers.reserve(tasks - 1);
+
+    for (int t = 1; t < tasks; t++)
+    {
+        workers.push_back(thread([&task, &errors, t]()
+        {
+            try
+            {
+                task(t);
+            }
+            catch (...)
+            {
+                errors[t] = current_exception();
+            }
+        }));
+    }
+
+    // the calling thread takes the first task
+    try
+    {
+        task(0);
+    }
+    catch (...)
+    {
+        errors[0] = current_exception();
+    }
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    for (int t = 0; t < tasks; t++)
+    {
+        if (errors[t])
+            rethrow_exception(errors[t]);
+    }
+}
+
+template <class Work>
+int Parallel::forEachChunk(int length, Work work)
+{
+    int chunks = length / getSerialThreshold();
+    if (chunks > getThreadCount())
+        chunks = getThreadCount();
+    if (chunks < 1)
+        chunks = 1;
+
+    forEachTask(chunks, [&](int chunk)
+    {
+        long long begin = (long long)length * chunk / chunks;
+        long long end = (long long)length * (chunk + 1) / chunks;
+        work((int)begin, (int)end, chunk);
+    });
+
+    return chunks;
+}
+
+template <class Task>
+void Parallel::forEachStolen(int tasks, int threads, Task task)
+{
+    if (threads > tasks)
+        threads = tasks;
+    if (threads < 1)
+        threads = 1;
+
+    struct Share
+    {
+        mutex lock;
+        int begin, end;
+    };
+    vector<Share> shares(threads);
+    for (int w = 0; w < threads; w++)
+    {
+        shares[w].begin = (long long)tasks * w / threads;
+        shares[w].end = (long long)tasks * (w + 1) / threads;
+    }
+
+    forEachTask(threads, [&](int worker)
+    {
+        Share &own = shares[worker];
+        while (true)
+        {
+            int i = -1;
+            {
+                lock_guard<mutex> guard(own.lock);
+                if (own.begin < own.end)
+                    i = own.begin++;
+            }
+
+            if (i != -1)
+            {
+                task(i, worker);
+                continue;
+            }
+
+            int victim = -1;
+            int most = 0;
+            for (int w = 0; w < threads; w++)
+            {
+                lock_guard<mutex> guard(shares[w].lock);
+                if (shares[w].end - shares[w].begin > most)
+                {
+                    most = shares[w].end - shares[w].begin;
+                    victim = w;
+                }
+            }
+            // every task has been taken
+            if (victim == -1)
+                return;
+
+            int from, to;
+            {
+                lock_guard<mutex> guard(shares[victim].lock);
+                int left = shares[victim].end - shares[victim].begin;
+                if (left <= 0)
+                    continue;
+                to = shares[victim].end;
+                from = to - (left + 1) / 2;
+                shares[victim].end = from;
+            }
+
+            lock_guard<mutex> guard(own.lock);
+            own.begin = from;
+            own.end = to;
+        }
+    });
+}
+
+// ############################ algorithms ############################
+template <class T, class Storage>
+void parallelSort(Array<T, Storage> &array)
+{
+    parallelSort(array, less<T>());
+}
+
+template <class T, class Storage, class Compare>
+void parallelSort(Array<T, Storage> &array, Compare comp)
+{
+    // every chunk is sorted on its own thread, then neighbouring chunks are merged pairwise
+    int length = array.compact();
+    if (length == 0)
+        return;
+
+    // a shared storage gets its own copy here, before the threads start writing
+    array.getIndex(0);
+    typename Array<T, Storage>::iterator first = array.begin();
+
+    int chunks = Parallel::forEachChunk(length, [&](int begin, int end, int)
+    {
+        sort(first + begin, first + end, comp);
+    });
+
+    vector<int> bounds;
+    for (int chunk = 0; chunk <= chunks; chunk++)
+    {
+        bounds.push_back((int)((long long)length * chunk / chunks));
+    }
+
+    for (int width = 1; width < chunks; width *= 2)
+    {
+        int merges = (chunks + 2 * width - 1) / (2 * width);
+        Parallel::forEachTask(merges, [&](int merge)
+        {
+            int low = merge * 2 * width;
+            int middle = low + width;
+            int high = min(low + 2 * width, chunks);
+            if (middle < high)
+                inplace_merge(first + bounds[low], first + bounds[middle], first + bounds[high], comp);
+        });
+    }
+}
+
+template <class T, class Storage>
+int parallelFind(const Array<T, Storage> &array, const T &value)
+{
+    return parallelFindIf(array, [&value](const T &item)
+    {
+        return item == value;
+    });
+}
+
+template <class T, class Storage, class Predicate>
+int parallelFindIf(const Array<T, Storage> &array, Predicate pred)
+{
+    // lowest matching index or -1, a chunk stops once a lower chunk has found a match
+    atomic<int> found(array.getLength());
+
+    Parallel::forEachChunk(array.getLength(), [&](int begin, int end, int chunk)
+    {
+        for (int i = begin; i < end && i < found.load(memory_order_relaxed); i++)
+        {
+            const T *item = array[i];
+            if (item && pred(*item))
+            {
+                int seen = found.load();
+                while (i < seen && !found.compare_exchange_weak(seen, i))
+                {
+                }
+                break;
+            }
+        }
+    });
+
+    return found.load() == array.getLength() ? -1 : found.load();
+}
+
+template <class T, class Storage>
+int parallelCount(const Array<T, Storage> &array, const T &value)
+{
+    return parallelCountIf(array, [&value](const T &item)
+    {
+        return item == value;
+    });
+}
+
+template <class T, class Storage, class Predicate>
+int parallelCountIf(const Array<T, Storage> &array, Predicate pred)
+{
+    vector<int> counts(Parallel::getThreadCount(), 0);
+
+    int chunks = Parallel::forEachChunk(array.getLength(), [&](int begin, int end, int chunk)
+    {
+        int count = 0;
+        for (int i = begin; i < end; i++)
+        {
+            const T *item = array[i];
+            if (item && pred(*item))
+                count++;
+        }
+        counts[chunk] = count;
+    });
+
+    int total = 0;
+    for (int chunk = 0; chunk < chunks; chunk++)
+    {
+        total += counts[chunk];
+    }
+    return total;
+}
+
+template <class T, class Storage, class Op>
+T parallelReduce(const Array<T, Storage> &array, T init, Op op)
+{
+    vector<T> partials(Parallel::getThreadCount(), init);
+    vector<char> hasPartial(Parallel::getThreadCount(), false);
+
+    int chunks = Parallel::forEachChunk(array.getLength(), [&](int begin, int end, int chunk)
+    {
+        // a chunk starts from its first item so init is only used once
+        bool started = false;
+        for (int i = begin; i < end; i++)
+        {
+            const T *item = array[i];
+            if (!item)
+                continue;
+            partials[chunk] = started ? op(partials[chunk], *item) : *item;
+            started = true;
+        }
+        hasPartial[chunk] = started;
+    });
+
+    T result = init;
+    for (int chunk = 0; chunk < chunks; chunk++)
+    {
+        if (hasPartial[chunk])
+            result = op(result, partials[chunk]);
+    }
+    return result;
+}
+
+template <class T, class Storage, class Func>
+void parallelTransform(Array<T, Storage> &array, Func func)
+{
+    if (array.getLength() == 0)
+        return;
+
+    // a shared storage gets its own copy here, before the threads start writing
+    array.getIndex(0);
+
+    Parallel::forEachChunk(array.getLength(), [&](int begin, int end, int chunk)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            T *item = array[i];
+            if (item)
+                *item = func(*item);
+        }
+    });
+}
@@ -0,0 +1,72 @@
+#ifndef ARRAYALGORITHMS_H
+#define ARRAYALGORITHMS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "array.h"
+using namespace std;
+
+/*
+Algorithms that work on an Array directly and split the work over threads
+empty slots are skipped, parallelSort moves the items to the front first
+arrays shorter than the serial threshold run on the calling thread
+link with -pthread
+*/
+
+// thread count and serial threshold used by every parallel algorithm
+class Parallel
+{
+public:
+    static int getThreadCount();
+    // 0 uses every core
+    static void setThreadCount(int threads);
+    static int getSerialThreshold();
+    static void setSerialThreshold(int items);
+
+    // runs task(0) to task(tasks - 1) on their own threads, rethrows the first exception
+    template <class Task>
+    static void forEachTask(int tasks, Task task);
+    // splits [0, length) into chunks and runs work(begin, end, chunk) on each
+    template <class Work>
+    static int forEachChunk(int length, Work work);
+    // runs task(i, worker) for every i in [0, tasks) on threads workers
+    // each worker starts with an even share and an idle worker steals half of the largest share left
+    template <class Task>
+    static void forEachStolen(int tasks, int threads, Task task);
+
+private:
+    static int &threadCount();
+    static int &serialThreshold();
+};
+
+template <class T, class Storage>
+void parallelSort(Array<T, Storage> &array);
+template <class T, class Storage, class Compare>
+void parallelSort(Array<T, Storage> &array, Compare comp);
+
+template <class T, class Storage>
+int parallelFind(const Array<T, Storage> &array, const T &value);
+template <class T, class Storage, class Predicate>
+int parallelFindIf(const Array<T, Storage> &array, Predicate pred);
+
+template <class T, class Storage>
+int parallelCount(const Array<T, Storage> &array, const T &value);
+template <class T, class Storage, class Predicate>
+int parallelCountIf(const Array<T, Storage> &array, Predicate pred);
+
+// op has to be associative, the partial results of the threads are combined with it
+template <class T, class Storage, class Op>
+T parallelReduce(const Array<T, Storage> &array, T init, Op op);
+
+// replaces every item with func(item)
+template <class T, class Storage, class Func>
+void parallelTransform(Array<T, Storage> &array, Func func);
+
+#include "arrayAlgorithms.cpp"
+
+#endif
@@ -0,0 +1,93 @@
+#include "arrayBinary.h"
+
+template <class T, class Storage>
+void writeBinary(const string &path, const Array<T, Storage> &array)
+{
+    static_assert(is_trivially_copyable<T>::value, "writeBinary needs a trivially copyable item type");
+    static_assert(!is_pointer<T>::value, "pointers can not be written to a file");
+
+    int length = array.getLength();
+    int wordCount = Occupancy::wordsFor(length);
+    size_t align = alignof(T) > 8 ? alignof(T) : 8;
+
+    BinaryHeader header = {{'A', 'R', 'R', 'B'}, BINARY_VERSION, BinaryTypeTag<T>::value, sizeof(T), length, array.countOccupied(), 0};
+    header.payloadOffset = (sizeof(BinaryHeader) + wordCount * sizeof(uint64_t) + align - 1) / align * align;
+
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out)
+        throw runtime_error("Could not open " + path + " for writing");
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    Occupancy occupancy(length);
+    for (int i = array.nextOccupied(0); i != -1; i = array.nextOccupied(i + 1))
+    {
+        occupancy.set(i);
+    }
+    for (int w = 0; w < wordCount; w++)
+    {
+        uint64_t bits = occupancy.getWord(w);
+        out.write(reinterpret_cast<const char *>(&bits), sizeof(bits));
+    }
+
+    static const char padding[64] = {};
+    size_t written = sizeof(BinaryHeader) + wordCount * sizeof(uint64_t);
+    while (written < header.payloadOffset)
+    {
+        size_t pad = header.payloadOffset - written < sizeof(padding) ? header.payloadOffset - written : sizeof(padding);
+        out.write(padding, pad);
+        written += pad;
+    }
+
+    typename aligned_storage<sizeof(T), alignof(T)>::type empty = {};
+    for (int i = 0; i < length; i++)
+    {
+        const T *item = array[i];
+        out.write(reinterpret_cast<const char *>(item ? item : reinterpret_cast<const T *>(&empty)), sizeof(T));
+    }
+
+    out.close();
+    if (!out)
+        throw runtime_error("Could not write " + path);
+}
+
+inline BinaryHeader readBinaryHeader(const string &path)
+{
+    ifstream in(path.c_str(), ios::binary);
+    if (!in)
+        throw runtime_error("Could not open " + path);
+
+    BinaryHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || string(header.magic, 4) != "ARRB")
+        throw runtime_error(path + " is not a binary array file");
+    if (header.version != BINARY_VERSION)
+        throw runtime_error(path + " has binary format version " + to_string(header.version) + ", expected " + to_string(BINARY_VERSION));
+
+    return header;
+}
+
+template <class T>
+MappedArray<T> readBinary(const string &path, typename MappedStorage<T>::Mode mode)
+{
+    BinaryHeader header = readBinaryHeader(path);
+    if (header.typeTag != BinaryTypeTag<T>::value || header.itemSize != sizeof(T))
+        throw runtime_error(path + " holds a different item type");
+    if (header.length < 0 || header.length > INT32_MAX || header.payloadOffset % alignof(T) != 0)
+        throw runtime_error(path + " has a broken header");
+
+    int length = header.length;
+    Occupancy occupancy(length);
+    ifstream in(path.c_str(), ios::binary);
+    in.seekg(sizeof(BinaryHeader));
+    for (int w = 0; w < Occupancy::wordsFor(length); w++)
+    {
+        uint64_t bits;
+        if (!in.read(reinterpret_cast<char *>(&bits), sizeof(bits)))
+            throw runtime_error(path + " is cut short");
+        occupancy.setWord(w, bits);
+    }
+    if (occupancy.count() != header.occupied)
+        throw runtime_error(path + " has a broken occupancy bitmap");
+
+    return MappedArray<T>(MappedStorage<T>(path, mode, header.payloadOffset, std::move(occupancy)));
+}
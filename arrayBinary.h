@@ -0,0 +1,50 @@
+#ifndef ARRAYBINARY_H
+#define ARRAYBINARY_H
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "mappedStorage.h"
+using namespace std;
+
+/*
+Binary file format for an Array of trivially copyable items, so expected results can be written once and mapped back in later runs
+header          BinaryHeader below
+occupancy       one bit per slot in 64 bit words, set when the slot holds an item
+payload         every slot as raw bytes starting at payloadOffset, empty slots are zeroed
+numbers are stored in the byte order of the machine that wrote the file
+*/
+struct BinaryHeader
+{
+    char magic[4]; // "ARRB"
+    uint32_t version;
+    uint32_t typeTag;  // kind of item, see BinaryTypeTag
+    uint32_t itemSize; // sizeof the item
+    int64_t length;
+    int64_t occupied;
+    uint64_t payloadOffset; // aligned for the item type
+};
+
+// 1 signed integer, 2 unsigned integer, 3 floating point, 4 enum, 0 anything else
+template <class T>
+struct BinaryTypeTag : integral_constant<uint32_t, is_enum<T>::value ? 4 : is_floating_point<T>::value ? 3 : is_signed<T>::value ? 1 : is_integral<T>::value ? 2 : 0>
+{
+};
+
+const uint32_t BINARY_VERSION = 1;
+
+// throws runtime_error when the file can not be written
+template <class T, class Storage>
+void writeBinary(const string &path, const Array<T, Storage> &array);
+
+// maps the payload of the file instead of reading it, throws runtime_error when the file is not a matching array
+template <class T>
+MappedArray<T> readBinary(const string &path, typename MappedStorage<T>::Mode mode = MappedStorage<T>::READ_ONLY);
+
+BinaryHeader readBinaryHeader(const string &path);
+
+#include "arrayBinary.cpp"
+
+#endif
@@ -0,0 +1,163 @@
+#include "arrayIterator.h"
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value>::ArrayIterator()
+{
+    store = NULL;
+    index = 0;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value>::ArrayIterator(Store *store, int index)
+{
+    this->store = store;
+    this->index = index;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value>::ArrayIterator(const ArrayIterator<T, Storage, T> &other)
+{
+    store = other.store;
+    index = other.index;
+}
+
+template <class T, class Storage, class Value>
+Value &ArrayIterator<T, Storage, Value>::operator*() const
+{
+    if (ARRAY_CHECKED && (index < 0 || index >= store->capacity()))
+        throw out_of_range("Array iterator is out of range");
+    if (ARRAY_CHECKED && !store->slot(index))
+        throw out_of_range("Array iterator cannot read an empty slot");
+
+    return *store->item(index);
+}
+
+template <class T, class Storage, class Value>
+Value *ArrayIterator<T, Storage, Value>::operator->() const
+{
+    return &**this;
+}
+
+template <class T, class Storage, class Value>
+Value &ArrayIterator<T, Storage, Value>::operator[](difference_type n) const
+{
+    return *(*this + n);
+}
+
+template <class T, class Storage, class Value>
+Value *ArrayIterator<T, Storage, Value>::get() const
+{
+    if (ARRAY_CHECKED && (index < 0 || index >= store->capacity()))
+        throw out_of_range("Array iterator is out of range");
+    return store->slot(index);
+}
+
+template <class T, class Storage, class Value>
+int ArrayIterator<T, Storage, Value>::getIndex() const
+{
+    return index;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> &ArrayIterator<T, Storage, Value>::operator++()
+{
+    index++;
+    return *this;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> ArrayIterator<T, Storage, Value>::operator++(int)
+{
+    ArrayIterator<T, Storage, Value> before(*this);
+    index++;
+    return before;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> &ArrayIterator<T, Storage, Value>::operator--()
+{
+    index--;
+    return *this;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> ArrayIterator<T, Storage, Value>::operator--(int)
+{
+    ArrayIterator<T, Storage, Value> before(*this);
+    index--;
+    return before;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> &ArrayIterator<T, Storage, Value>::operator+=(difference_type n)
+{
+    index += n;
+    return *this;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> &ArrayIterator<T, Storage, Value>::operator-=(difference_type n)
+{
+    index -= n;
+    return *this;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> ArrayIterator<T, Storage, Value>::operator+(difference_type n) const
+{
+    return ArrayIterator<T, Storage, Value>(store, index + n);
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> ArrayIterator<T, Storage, Value>::operator-(difference_type n) const
+{
+    return ArrayIterator<T, Storage, Value>(store, index - n);
+}
+
+template <class T, class Storage, class Value>
+typename ArrayIterator<T, Storage, Value>::difference_type ArrayIterator<T, Storage, Value>::operator-(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index - rhs.index;
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator==(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index == rhs.index && store == rhs.store;
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator!=(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return !(*this == rhs);
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator<(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index < rhs.index;
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator>(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index > rhs.index;
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator<=(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index <= rhs.index;
+}
+
+template <class T, class Storage, class Value>
+bool ArrayIterator<T, Storage, Value>::operator>=(const ArrayIterator<T, Storage, Value> &rhs) const
+{
+    return index >= rhs.index;
+}
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> operator+(ptrdiff_t n, const ArrayIterator<T, Storage, Value> &it)
+{
+    return it + n;
+}
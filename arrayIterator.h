@@ -0,0 +1,68 @@
+#ifndef ARRAYITERATOR_H
+#define ARRAYITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+using namespace std;
+
+/*
+Random access iterator over the slots of an Array
+Value is T for a normal iterator and const T for a const iterator
+* gives the item in the slot, get() gives the slot pointer which is NULL for an empty slot
+while ARRAY_CHECKED is 1 both throw out_of_range for an index outside the storage, * also for an empty slot
+*/
+template <class T, class Storage, class Value>
+class ArrayIterator
+{
+public:
+    typedef random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef Value *pointer;
+    typedef Value &reference;
+    typedef typename conditional<is_const<Value>::value, const Storage, Storage>::type Store;
+
+    ArrayIterator();
+    ArrayIterator(Store *store, int index);
+    // lets an iterator turn into a const iterator
+    ArrayIterator(const ArrayIterator<T, Storage, T> &other);
+
+    Value &operator*() const;
+    Value *operator->() const;
+    Value &operator[](difference_type n) const;
+    Value *get() const;
+    int getIndex() const;
+
+    ArrayIterator<T, Storage, Value> &operator++();
+    ArrayIterator<T, Storage, Value> operator++(int);
+    ArrayIterator<T, Storage, Value> &operator--();
+    ArrayIterator<T, Storage, Value> operator--(int);
+    ArrayIterator<T, Storage, Value> &operator+=(difference_type n);
+    ArrayIterator<T, Storage, Value> &operator-=(difference_type n);
+    ArrayIterator<T, Storage, Value> operator+(difference_type n) const;
+    ArrayIterator<T, Storage, Value> operator-(difference_type n) const;
+    difference_type operator-(const ArrayIterator<T, Storage, Value> &rhs) const;
+
+    bool operator==(const ArrayIterator<T, Storage, Value> &rhs) const;
+    bool operator!=(const ArrayIterator<T, Storage, Value> &rhs) const;
+    bool operator<(const ArrayIterator<T, Storage, Value> &rhs) const;
+    bool operator>(const ArrayIterator<T, Storage, Value> &rhs) const;
+    bool operator<=(const ArrayIterator<T, Storage, Value> &rhs) const;
+    bool operator>=(const ArrayIterator<T, Storage, Value> &rhs) const;
+
+private:
+    template <class, class, class>
+    friend class ArrayIterator;
+
+    Store *store;
+    int index;
+};
+
+template <class T, class Storage, class Value>
+ArrayIterator<T, Storage, Value> operator+(ptrdiff_t n, const ArrayIterator<T, Storage, Value> &it);
+
+#include "arrayIterator.cpp"
+
+#endif
@@ -0,0 +1,145 @@
+#include "arraySerializer.h"
+
+template <class T>
+struct ItemKind : integral_constant<int, is_integral<T>::value ? 1 : is_floating_point<T>::value ? 2 : 0>
+{
+};
+
+inline void put(string &out, const char *text, size_t length)
+{
+    out.append(text, length);
+}
+
+inline void put(ostream &out, const char *text, size_t length)
+{
+    out.write(text, length);
+}
+
+template <class Out, class T, class Storage>
+void writeItem(Out &out, const Array<T, Storage> &item)
+{
+    put(out, "[ ", 2);
+    for (typename Array<T, Storage>::const_iterator it = item.begin(); it != item.end(); ++it)
+    {
+        if (it.get())
+            writeItem(out, *it.get());
+        else
+            put(out, "NULL", 4);
+        if (it.getIndex() != item.getLength() - 1)
+            put(out, ", ", 2);
+    }
+    put(out, " ]", 2);
+}
+
+template <class Out>
+void writeItem(Out &out, const string &item)
+{
+    put(out, item.data(), item.size());
+}
+
+template <class Out, class T>
+void writeItem(Out &out, const T &item)
+{
+    writeValue(out, item, ItemKind<T>());
+}
+
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 0> kind)
+{
+    string text = to_string(item);
+    put(out, text.data(), text.size());
+}
+
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 1>)
+{
+    // digits are built backwards in a stack buffer
+    char digits[24];
+    int at = 24;
+    bool negative = item < 0;
+    unsigned long long value = negative ? 0ull - (unsigned long long)item : (unsigned long long)item;
+
+    do
+    {
+        digits[--at] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    if (negative)
+        digits[--at] = '-';
+
+    put(out, digits + at, 24 - at);
+}
+
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 2> kind)
+{
+    // same format as std::to_string
+    char text[512];
+    int length = snprintf(text, sizeof(text), "%Lf", (long double)item);
+    if (length >= (int)sizeof(text))
+    {
+        string large = to_string((long double)item);
+        put(out, large.data(), large.size());
+    }
+    else
+        put(out, text, length);
+}
+
+inline size_t estimateItem(const string &item)
+{
+    return item.size();
+}
+
+template <class T, class Storage>
+size_t estimateItem(const Array<T, Storage> &item)
+{
+    // brackets plus a separator per slot
+    size_t length = 4 + 2 * item.getLength();
+    for (typename Array<T, Storage>::const_iterator it = item.begin(); it != item.end(); ++it)
+    {
+        length += it.get() ? estimateItem(*it.get()) : 4;
+    }
+    return length;
+}
+
+template <class T>
+size_t estimateItem(const T &)
+{
+    // a guess, numbers are mostly short
+    return is_floating_point<T>::value ? 12 : 8;
+}
+
+template <class T, class Storage>
+size_t estimateLength(const Array<T, Storage> &array)
+{
+    return estimateItem(array);
+}
+
+template <class T, class Storage>
+void writeTo(string &out, const Array<T, Storage> &array)
+{
+    out.reserve(out.size() + estimateLength(array));
+    writeItem(out, array);
+}
+
+template <class T, class Storage>
+void writeTo(ostream &out, const Array<T, Storage> &array)
+{
+    writeItem(out, array);
+}
+
+template <class T, class Storage>
+ostream &operator<<(ostream &out, const Array<T, Storage> &array)
+{
+    writeTo(out, array);
+    return out;
+}
+
+template <class T, class Storage>
+string to_string(const Array<T, Storage> &array)
+{
+    string obj;
+    writeTo(obj, array);
+    return obj;
+}
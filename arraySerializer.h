@@ -0,0 +1,55 @@
+#ifndef ARRAYSERIALIZER_H
+#define ARRAYSERIALIZER_H
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <type_traits>
+using namespace std;
+
+/*
+Writes an Array as text straight into a string or a stream, in the same "[ 1, NULL, 3 ]" format as to_string
+nothing is copied and a string output is grown once from estimateLength
+numbers, strings and nested arrays are written without temporaries, any other item goes through its to_string
+*/
+
+template <class T, class Storage>
+class Array;
+
+template <class T, class Storage>
+void writeTo(string &out, const Array<T, Storage> &array);
+template <class T, class Storage>
+void writeTo(ostream &out, const Array<T, Storage> &array);
+template <class T, class Storage>
+ostream &operator<<(ostream &out, const Array<T, Storage> &array);
+
+template <class T, class Storage>
+size_t estimateLength(const Array<T, Storage> &array);
+
+// ######## item writers, overloaded per item kind ########
+void put(string &out, const char *text, size_t length);
+void put(ostream &out, const char *text, size_t length);
+
+template <class Out>
+void writeItem(Out &out, const string &item);
+template <class Out, class T, class Storage>
+void writeItem(Out &out, const Array<T, Storage> &item);
+template <class Out, class T>
+void writeItem(Out &out, const T &item);
+
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 0> kind); // anything with a to_string
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 1> kind); // integers
+template <class Out, class T>
+void writeValue(Out &out, const T &item, integral_constant<int, 2> kind); // floating point
+
+size_t estimateItem(const string &item);
+template <class T, class Storage>
+size_t estimateItem(const Array<T, Storage> &item);
+template <class T>
+size_t estimateItem(const T &item);
+
+#include "arraySerializer.cpp"
+
+#endif
@@ -0,0 +1,1097 @@
+#include "arrayStorage.h"
+
+// ############################ Occupancy code ############################
+inline int Occupancy::wordsFor(int length)
+{
+    return (length + 63) / 64;
+}
+
+inline Occupancy::Occupancy(int length)
+{
+    this->length = length;
+    allocate();
+    setBits = 0;
+    hint = 0;
+}
+
+inline Occupancy::Occupancy(const Occupancy &copy)
+{
+    length = copy.length;
+    setBits = copy.setBits;
+    hint = copy.hint;
+    allocate();
+    for (int i = 0; i < wordsFor(length); i++)
+    {
+        words[i] = copy.words[i];
+    }
+}
+
+inline Occupancy::Occupancy(Occupancy &&other)
+{
+    length = 0;
+    words = &local;
+    *this = std::move(other);
+}
+
+inline Occupancy::~Occupancy()
+{
+    release();
+}
+
+inline Occupancy &Occupancy::operator=(const Occupancy &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    if (wordsFor(length) != wordsFor(rhs.length))
+    {
+        release();
+        length = rhs.length;
+        allocate();
+    }
+    length = rhs.length;
+    setBits = rhs.setBits;
+    hint = rhs.hint;
+    for (int i = 0; i < wordsFor(length); i++)
+    {
+        words[i] = rhs.words[i];
+    }
+
+    return *this;
+}
+
+inline Occupancy &Occupancy::operator=(Occupancy &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    release();
+    // a single inline word has to be copied, a heap array can be taken over
+    if (rhs.words == &rhs.local)
+    {
+        local = rhs.local;
+        words = &local;
+    }
+    else
+        words = rhs.words;
+    length = rhs.length;
+    setBits = rhs.setBits;
+    hint = rhs.hint;
+
+    rhs.words = &rhs.local;
+    rhs.local = 0;
+    rhs.length = 0;
+    rhs.setBits = 0;
+    rhs.hint = 0;
+
+    return *this;
+}
+
+inline void Occupancy::allocate()
+{
+    // up to 64 slots fit in the inline word, so small arrays never touch the heap for their bitmap
+    local = 0;
+    words = wordsFor(length) > 1 ? new uint64_t[wordsFor(length)]() : &local;
+}
+
+inline void Occupancy::release()
+{
+    if (words != &local)
+        delete[] words;
+    words = &local;
+}
+
+inline bool Occupancy::test(int i) const
+{
+    return (words[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void Occupancy::set(int i)
+{
+    if (!test(i))
+    {
+        words[i >> 6] |= uint64_t(1) << (i & 63);
+        setBits++;
+    }
+}
+
+inline void Occupancy::reset(int i)
+{
+    if (test(i))
+    {
+        words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+        setBits--;
+        if (i < hint)
+            hint = i;
+    }
+}
+
+inline void Occupancy::resetAll()
+{
+    for (int i = 0; i < wordsFor(length); i++)
+    {
+        words[i] = 0;
+    }
+    setBits = 0;
+    hint = 0;
+}
+
+inline void Occupancy::setAll()
+{
+    for (int i = 0; i < wordsFor(length); i++)
+    {
+        words[i] = ~uint64_t(0);
+    }
+    if (length & 63)
+    {
+        words[length >> 6] = (uint64_t(1) << (length & 63)) - 1;
+    }
+    setBits = length;
+    hint = length;
+}
+
+inline void Occupancy::resize(int newLength)
+{
+    // bits past the new length are dropped
+    Occupancy resized(newLength);
+    int keep = newLength < length ? newLength : length;
+
+    for (int i = 0; i < wordsFor(keep); i++)
+    {
+        resized.words[i] = words[i];
+    }
+    if (keep & 63)
+    {
+        resized.words[keep >> 6] &= (uint64_t(1) << (keep & 63)) - 1;
+    }
+
+    int oldHint = hint;
+    *this = std::move(resized);
+    hint = oldHint;
+
+    setBits = 0;
+    for (int i = 0; i < wordsFor(length); i++)
+    {
+        setBits += __builtin_popcountll(words[i]);
+    }
+    if (hint > keep)
+        hint = keep;
+}
+
+inline int Occupancy::findFirstUnset(int limit)
+{
+    // skips whole words of filled slots, the hint makes repeated appends O(1)
+    for (int w = hint >> 6; w < wordsFor(length); w++)
+    {
+        uint64_t freeBits = ~words[w];
+        if (w == hint >> 6)
+            freeBits &= ~uint64_t(0) << (hint & 63);
+
+        if (freeBits)
+        {
+            int i = (w << 6) + __builtin_ctzll(freeBits);
+            if (i >= length)
+                break;
+
+            hint = i;
+            return i < limit ? i : -1;
+        }
+    }
+
+    hint = length;
+    return -1;
+}
+
+inline int Occupancy::findNextSet(int from) const
+{
+    if (from < 0)
+        from = 0;
+
+    for (int w = from >> 6; w < wordsFor(length); w++)
+    {
+        uint64_t setInWord = words[w];
+        if (w == from >> 6)
+            setInWord &= ~uint64_t(0) << (from & 63);
+
+        if (setInWord)
+            return (w << 6) + __builtin_ctzll(setInWord);
+    }
+
+    return -1;
+}
+
+inline int Occupancy::count() const
+{
+    return setBits;
+}
+
+inline uint64_t Occupancy::getWord(int w) const
+{
+    return words[w];
+}
+
+inline void Occupancy::setWord(int w, uint64_t bits)
+{
+    // bits past the length are dropped
+    if (w == length >> 6)
+        bits &= (uint64_t(1) << (length & 63)) - 1;
+
+    setBits += __builtin_popcountll(bits) - __builtin_popcountll(words[w]);
+    words[w] = bits;
+    if (~bits && w * 64 < hint)
+        hint = w * 64;
+}
+
+inline int Occupancy::getLength() const
+{
+    return length;
+}
+
+// ############################ PointerStorage code ############################
+template <class T, class Nodes>
+PointerStorage<T, Nodes>::PointerStorage(int capacity) : occupancy(capacity)
+{
+    slots = new T *[capacity]();
+    cap = capacity;
+}
+
+template <class T, class Nodes>
+PointerStorage<T, Nodes>::PointerStorage(const PointerStorage<T, Nodes> &copy) : occupancy(copy.occupancy)
+{
+    slots = new T *[copy.cap]();
+    cap = copy.cap;
+
+    for (int i = 0; i < cap; i++)
+    {
+        if (copy.slots[i])
+            slots[i] = nodes.create(*copy.slots[i]);
+    }
+}
+
+template <class T, class Nodes>
+PointerStorage<T, Nodes>::PointerStorage(PointerStorage<T, Nodes> &&other) : occupancy(std::move(other.occupancy)), nodes(std::move(other.nodes))
+{
+    slots = other.slots;
+    cap = other.cap;
+
+    other.slots = NULL;
+    other.cap = 0;
+}
+
+template <class T, class Nodes>
+PointerStorage<T, Nodes>::~PointerStorage()
+{
+    destroyAll();
+    delete[] slots;
+}
+
+template <class T, class Nodes>
+PointerStorage<T, Nodes> &PointerStorage<T, Nodes>::operator=(const PointerStorage<T, Nodes> &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    // the slot table and the nodes are reused when the sizes allow it
+    destroyAll();
+    if (cap != rhs.cap)
+    {
+        delete[] slots;
+        cap = rhs.cap;
+        slots = new T *[cap]();
+    }
+    occupancy = rhs.occupancy;
+
+    for (int i = 0; i < cap; i++)
+    {
+        if (rhs.slots[i])
+            slots[i] = nodes.create(*rhs.slots[i]);
+    }
+
+    return *this;
+}
+
+template <class T, class Nodes>
+PointerStorage<T, Nodes> &PointerStorage<T, Nodes>::operator=(PointerStorage<T, Nodes> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    destroyAll();
+    delete[] slots;
+
+    slots = rhs.slots;
+    cap = rhs.cap;
+    occupancy = std::move(rhs.occupancy);
+    nodes = std::move(rhs.nodes);
+
+    rhs.slots = NULL;
+    rhs.cap = 0;
+
+    return *this;
+}
+
+template <class T, class Nodes>
+int PointerStorage<T, Nodes>::capacity() const
+{
+    return cap;
+}
+
+template <class T, class Nodes>
+T *PointerStorage<T, Nodes>::slot(int i)
+{
+    return slots[i];
+}
+
+template <class T, class Nodes>
+const T *PointerStorage<T, Nodes>::slot(int i) const
+{
+    return slots[i];
+}
+
+template <class T, class Nodes>
+T *PointerStorage<T, Nodes>::item(int i)
+{
+    return slots[i];
+}
+
+template <class T, class Nodes>
+const T *PointerStorage<T, Nodes>::item(int i) const
+{
+    return slots[i];
+}
+
+template <class T, class Nodes>
+T *PointerStorage<T, Nodes>::writableSlot(int i)
+{
+    return slot(i);
+}
+
+template <class T, class Nodes>
+template <class... Args>
+void PointerStorage<T, Nodes>::construct(int i, Args &&...args)
+{
+    slots[i] = nodes.create(std::forward<Args>(args)...);
+    occupancy.set(i);
+}
+
+template <class T, class Nodes>
+void PointerStorage<T, Nodes>::destroy(int i)
+{
+    nodes.release(slots[i]);
+    slots[i] = NULL;
+    occupancy.reset(i);
+}
+
+template <class T, class Nodes>
+void PointerStorage<T, Nodes>::destroyAll()
+{
+    for (int i = occupancy.findNextSet(0); i != -1; i = occupancy.findNextSet(i + 1))
+    {
+        destroy(i);
+    }
+    nodes.reset();
+}
+
+template <class T, class Nodes>
+void PointerStorage<T, Nodes>::resize(int capacity)
+{
+    // items are handed over by pointer, nothing gets copied
+    T **n_slots = new T *[capacity]();
+
+    for (int i = 0; i < cap; i++)
+    {
+        if (i < capacity)
+            n_slots[i] = slots[i];
+        else if (slots[i])
+            nodes.release(slots[i]);
+    }
+
+    delete[] slots;
+
+    slots = n_slots;
+    occupancy.resize(capacity);
+    cap = capacity;
+}
+
+template <class T, class Nodes>
+int PointerStorage<T, Nodes>::firstEmpty(int limit)
+{
+    return occupancy.findFirstUnset(limit);
+}
+
+template <class T, class Nodes>
+int PointerStorage<T, Nodes>::nextOccupied(int from) const
+{
+    return occupancy.findNextSet(from);
+}
+
+template <class T, class Nodes>
+int PointerStorage<T, Nodes>::countOccupied() const
+{
+    return occupancy.count();
+}
+
+// ############################ ContiguousStorage code ############################
+template <class T>
+ContiguousStorage<T>::ContiguousStorage(int capacity) : occupancy(capacity)
+{
+    buffer = new Cell[capacity];
+    cap = capacity;
+}
+
+template <class T>
+ContiguousStorage<T>::ContiguousStorage(const ContiguousStorage<T> &copy) : occupancy(copy.cap)
+{
+    buffer = new Cell[copy.cap];
+    cap = copy.cap;
+
+    for (int i = 0; i < cap; i++)
+    {
+        if (copy.occupancy.test(i))
+            construct(i, *copy.slot(i));
+    }
+}
+
+template <class T>
+ContiguousStorage<T>::ContiguousStorage(ContiguousStorage<T> &&other) : occupancy(std::move(other.occupancy))
+{
+    buffer = other.buffer;
+    cap = other.cap;
+
+    other.buffer = NULL;
+    other.cap = 0;
+}
+
+template <class T>
+ContiguousStorage<T>::~ContiguousStorage()
+{
+    destroyAll();
+    delete[] buffer;
+}
+
+template <class T>
+ContiguousStorage<T> &ContiguousStorage<T>::operator=(const ContiguousStorage<T> &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    destroyAll();
+    delete[] buffer;
+
+    cap = rhs.cap;
+    buffer = new Cell[cap];
+    occupancy.resize(cap);
+
+    for (int i = 0; i < cap; i++)
+    {
+        if (rhs.occupancy.test(i))
+            construct(i, *rhs.slot(i));
+    }
+
+    return *this;
+}
+
+template <class T>
+ContiguousStorage<T> &ContiguousStorage<T>::operator=(ContiguousStorage<T> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    destroyAll();
+    delete[] buffer;
+
+    buffer = rhs.buffer;
+    cap = rhs.cap;
+    occupancy = std::move(rhs.occupancy);
+
+    rhs.buffer = NULL;
+    rhs.cap = 0;
+
+    return *this;
+}
+
+template <class T>
+int ContiguousStorage<T>::capacity() const
+{
+    return cap;
+}
+
+template <class T>
+T *ContiguousStorage<T>::slot(int i)
+{
+    return occupancy.test(i) ? reinterpret_cast<T *>(&buffer[i]) : NULL;
+}
+
+template <class T>
+const T *ContiguousStorage<T>::slot(int i) const
+{
+    return occupancy.test(i) ? reinterpret_cast<const T *>(&buffer[i]) : NULL;
+}
+
+template <class T>
+T *ContiguousStorage<T>::item(int i)
+{
+    return reinterpret_cast<T *>(&buffer[i]);
+}
+
+template <class T>
+const T *ContiguousStorage<T>::item(int i) const
+{
+    return reinterpret_cast<const T *>(&buffer[i]);
+}
+
+template <class T>
+T *ContiguousStorage<T>::writableSlot(int i)
+{
+    return slot(i);
+}
+
+template <class T>
+T *ContiguousStorage<T>::data()
+{
+    return reinterpret_cast<T *>(buffer);
+}
+
+template <class T>
+const T *ContiguousStorage<T>::data() const
+{
+    return reinterpret_cast<const T *>(buffer);
+}
+
+template <class T>
+template <class... Args>
+void ContiguousStorage<T>::construct(int i, Args &&...args)
+{
+    new (&buffer[i]) T(std::forward<Args>(args)...);
+    occupancy.set(i);
+}
+
+template <class T>
+void ContiguousStorage<T>::destroy(int i)
+{
+    reinterpret_cast<T *>(&buffer[i])->~T();
+    occupancy.reset(i);
+}
+
+template <class T>
+void ContiguousStorage<T>::destroyAll()
+{
+    for (int i = occupancy.findNextSet(0); i != -1; i = occupancy.findNextSet(i + 1))
+    {
+        destroy(i);
+    }
+}
+
+template <class T>
+void ContiguousStorage<T>::resize(int capacity)
+{
+    // items are moved into the new buffer
+    Cell *n_buffer = new Cell[capacity];
+    Occupancy n_occupancy(capacity);
+
+    for (int i = 0; i < cap && i < capacity; i++)
+    {
+        if (occupancy.test(i))
+        {
+            new (&n_buffer[i]) T(std::move(*reinterpret_cast<T *>(&buffer[i])));
+            n_occupancy.set(i);
+        }
+    }
+
+    destroyAll();
+    delete[] buffer;
+
+    buffer = n_buffer;
+    occupancy = n_occupancy;
+    cap = capacity;
+}
+
+template <class T>
+int ContiguousStorage<T>::firstEmpty(int limit)
+{
+    return occupancy.findFirstUnset(limit);
+}
+
+template <class T>
+int ContiguousStorage<T>::nextOccupied(int from) const
+{
+    return occupancy.findNextSet(from);
+}
+
+template <class T>
+int ContiguousStorage<T>::countOccupied() const
+{
+    return occupancy.count();
+}
+
+template <class T>
+const Occupancy &ContiguousStorage<T>::getOccupancy() const
+{
+    return occupancy;
+}
+
+// ############################ SmallStorage code ############################
+template <class T, int N>
+SmallStorage<T, N>::SmallStorage(int capacity) : occupancy(capacity > N ? capacity : N)
+{
+    cap = capacity > N ? capacity : N;
+    buffer = cap > N ? new Cell[cap] : local;
+}
+
+template <class T, int N>
+SmallStorage<T, N>::SmallStorage(const SmallStorage<T, N> &copy) : occupancy(copy.cap)
+{
+    cap = copy.cap;
+    buffer = cap > N ? new Cell[cap] : local;
+
+    for (int i = copy.occupancy.findNextSet(0); i != -1; i = copy.occupancy.findNextSet(i + 1))
+    {
+        construct(i, *copy.item(i));
+    }
+}
+
+template <class T, int N>
+SmallStorage<T, N>::SmallStorage(SmallStorage<T, N> &&other) : occupancy(N)
+{
+    cap = N;
+    buffer = local;
+    take(other);
+}
+
+template <class T, int N>
+SmallStorage<T, N>::~SmallStorage()
+{
+    destroyAll();
+    if (buffer != local)
+        delete[] buffer;
+}
+
+template <class T, int N>
+SmallStorage<T, N> &SmallStorage<T, N>::operator=(const SmallStorage<T, N> &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    SmallStorage<T, N> copy(rhs);
+    *this = std::move(copy);
+
+    return *this;
+}
+
+template <class T, int N>
+SmallStorage<T, N> &SmallStorage<T, N>::operator=(SmallStorage<T, N> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    destroyAll();
+    if (buffer != local)
+        delete[] buffer;
+
+    cap = N;
+    buffer = local;
+    occupancy = Occupancy(N);
+    take(rhs);
+
+    return *this;
+}
+
+template <class T, int N>
+void SmallStorage<T, N>::take(SmallStorage<T, N> &other)
+{
+    // a heap buffer is taken over, inline items have to be moved one by one
+    // other is left empty with its inline buffer
+    if (other.buffer != other.local)
+    {
+        buffer = other.buffer;
+        cap = other.cap;
+        occupancy = std::move(other.occupancy);
+
+        other.buffer = other.local;
+        other.cap = N;
+        other.occupancy = Occupancy(N);
+        return;
+    }
+
+    for (int i = other.occupancy.findNextSet(0); i != -1; i = other.occupancy.findNextSet(i + 1))
+    {
+        construct(i, std::move(*other.item(i)));
+    }
+    other.destroyAll();
+}
+
+template <class T, int N>
+int SmallStorage<T, N>::capacity() const
+{
+    return cap;
+}
+
+template <class T, int N>
+T *SmallStorage<T, N>::slot(int i)
+{
+    return occupancy.test(i) ? reinterpret_cast<T *>(&buffer[i]) : NULL;
+}
+
+template <class T, int N>
+const T *SmallStorage<T, N>::slot(int i) const
+{
+    return occupancy.test(i) ? reinterpret_cast<const T *>(&buffer[i]) : NULL;
+}
+
+template <class T, int N>
+T *SmallStorage<T, N>::item(int i)
+{
+    return reinterpret_cast<T *>(&buffer[i]);
+}
+
+template <class T, int N>
+const T *SmallStorage<T, N>::item(int i) const
+{
+    return reinterpret_cast<const T *>(&buffer[i]);
+}
+
+template <class T, int N>
+T *SmallStorage<T, N>::writableSlot(int i)
+{
+    return slot(i);
+}
+
+template <class T, int N>
+T *SmallStorage<T, N>::data()
+{
+    return reinterpret_cast<T *>(buffer);
+}
+
+template <class T, int N>
+const T *SmallStorage<T, N>::data() const
+{
+    return reinterpret_cast<const T *>(buffer);
+}
+
+template <class T, int N>
+template <class... Args>
+void SmallStorage<T, N>::construct(int i, Args &&...args)
+{
+    new (&buffer[i]) T(std::forward<Args>(args)...);
+    occupancy.set(i);
+}
+
+template <class T, int N>
+void SmallStorage<T, N>::destroy(int i)
+{
+    reinterpret_cast<T *>(&buffer[i])->~T();
+    occupancy.reset(i);
+}
+
+template <class T, int N>
+void SmallStorage<T, N>::destroyAll()
+{
+    for (int i = occupancy.findNextSet(0); i != -1; i = occupancy.findNextSet(i + 1))
+    {
+        destroy(i);
+    }
+}
+
+template <class T, int N>
+void SmallStorage<T, N>::resize(int capacity)
+{
+    int n_cap = capacity > N ? capacity : N;
+
+    // staying inline only drops the items that no longer fit
+    if (n_cap == N && buffer == local)
+    {
+        for (int i = occupancy.findNextSet(capacity); i != -1; i = occupancy.findNextSet(i + 1))
+        {
+            destroy(i);
+        }
+        return;
+    }
+
+    // items are moved into the new buffer
+    Cell *n_buffer = n_cap > N ? new Cell[n_cap] : local;
+    Occupancy n_occupancy(n_cap);
+
+    for (int i = occupancy.findNextSet(0); i != -1 && i < capacity; i = occupancy.findNextSet(i + 1))
+    {
+        new (&n_buffer[i]) T(std::move(*reinterpret_cast<T *>(&buffer[i])));
+        n_occupancy.set(i);
+    }
+
+    destroyAll();
+    if (buffer != local)
+        delete[] buffer;
+
+    buffer = n_buffer;
+    occupancy = std::move(n_occupancy);
+    cap = n_cap;
+}
+
+template <class T, int N>
+int SmallStorage<T, N>::firstEmpty(int limit)
+{
+    return occupancy.findFirstUnset(limit);
+}
+
+template <class T, int N>
+int SmallStorage<T, N>::nextOccupied(int from) const
+{
+    return occupancy.findNextSet(from);
+}
+
+template <class T, int N>
+int SmallStorage<T, N>::countOccupied() const
+{
+    return occupancy.count();
+}
+
+template <class T, int N>
+const Occupancy &SmallStorage<T, N>::getOccupancy() const
+{
+    return occupancy;
+}
+
+template <class T, int N>
+bool SmallStorage<T, N>::isInline() const
+{
+    return buffer == local;
+}
+
+// ############################ SharedStorage code ############################
+template <class T, class Inner>
+SharedStorage<T, Inner>::Rep::Rep(int capacity) : store(capacity)
+{
+    refs = 1;
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner>::Rep::Rep(const Inner &copy) : store(copy)
+{
+    refs = 1;
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner>::SharedStorage(int capacity)
+{
+    rep = new Rep(capacity);
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner>::SharedStorage(const SharedStorage<T, Inner> &copy)
+{
+    rep = copy.rep;
+    if (rep)
+        rep->refs++;
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner>::SharedStorage(SharedStorage<T, Inner> &&other)
+{
+    rep = other.rep;
+    other.rep = NULL;
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner>::~SharedStorage()
+{
+    release();
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner> &SharedStorage<T, Inner>::operator=(const SharedStorage<T, Inner> &rhs)
+{
+    if (rep == rhs.rep)
+    {
+        return *this;
+    }
+
+    release();
+    rep = rhs.rep;
+    if (rep)
+        rep->refs++;
+
+    return *this;
+}
+
+template <class T, class Inner>
+SharedStorage<T, Inner> &SharedStorage<T, Inner>::operator=(SharedStorage<T, Inner> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    release();
+    rep = rhs.rep;
+    rhs.rep = NULL;
+
+    return *this;
+}
+
+template <class T, class Inner>
+int SharedStorage<T, Inner>::capacity() const
+{
+    return rep ? rep->store.capacity() : 0;
+}
+
+template <class T, class Inner>
+T *SharedStorage<T, Inner>::slot(int i)
+{
+    // reading does not give up the sharing, writableSlot does
+    const SharedStorage<T, Inner> &self = *this;
+    return const_cast<T *>(self.slot(i));
+}
+
+template <class T, class Inner>
+const T *SharedStorage<T, Inner>::slot(int i) const
+{
+    const Inner &store = rep->store;
+    return store.slot(i);
+}
+
+template <class T, class Inner>
+T *SharedStorage<T, Inner>::item(int i)
+{
+    const SharedStorage<T, Inner> &self = *this;
+    return const_cast<T *>(self.item(i));
+}
+
+template <class T, class Inner>
+const T *SharedStorage<T, Inner>::item(int i) const
+{
+    const Inner &store = rep->store;
+    return store.item(i);
+}
+
+template <class T, class Inner>
+T *SharedStorage<T, Inner>::writableSlot(int i)
+{
+    return detach().slot(i);
+}
+
+template <class T, class Inner>
+T *SharedStorage<T, Inner>::data()
+{
+    const SharedStorage<T, Inner> &self = *this;
+    return const_cast<T *>(self.data());
+}
+
+template <class T, class Inner>
+const T *SharedStorage<T, Inner>::data() const
+{
+    if (!rep)
+        return NULL;
+
+    const Inner &store = rep->store;
+    return store.data();
+}
+
+template <class T, class Inner>
+template <class... Args>
+void SharedStorage<T, Inner>::construct(int i, Args &&...args)
+{
+    detach().construct(i, std::forward<Args>(args)...);
+}
+
+template <class T, class Inner>
+void SharedStorage<T, Inner>::destroy(int i)
+{
+    detach().destroy(i);
+}
+
+template <class T, class Inner>
+void SharedStorage<T, Inner>::destroyAll()
+{
+    // a shared storage is left to its other owners instead of being copied and emptied
+    if (rep && rep->refs > 1)
+    {
+        int capacity = rep->store.capacity();
+        release();
+        rep = new Rep(capacity);
+    }
+    else if (rep)
+        rep->store.destroyAll();
+}
+
+template <class T, class Inner>
+void SharedStorage<T, Inner>::resize(int capacity)
+{
+    detach().resize(capacity);
+}
+
+template <class T, class Inner>
+int SharedStorage<T, Inner>::firstEmpty(int limit)
+{
+    if (!isShared())
+        return rep ? rep->store.firstEmpty(limit) : -1;
+
+    // the search hint of a shared storage belongs to every owner, so the filled slots are walked without it
+    for (int i = 0; i < limit; i++)
+    {
+        if (rep->store.nextOccupied(i) != i)
+            return i;
+    }
+    return -1;
+}
+
+template <class T, class Inner>
+int SharedStorage<T, Inner>::nextOccupied(int from) const
+{
+    return rep ? rep->store.nextOccupied(from) : -1;
+}
+
+template <class T, class Inner>
+int SharedStorage<T, Inner>::countOccupied() const
+{
+    return rep ? rep->store.countOccupied() : 0;
+}
+
+template <class T, class Inner>
+const Occupancy &SharedStorage<T, Inner>::getOccupancy() const
+{
+    return rep->store.getOccupancy();
+}
+
+template <class T, class Inner>
+bool SharedStorage<T, Inner>::isShared() const
+{
+    return rep && rep->refs > 1;
+}
+
+template <class T, class Inner>
+Inner &SharedStorage<T, Inner>::detach()
+{
+    if (!rep)
+        rep = new Rep(0);
+    else if (rep->refs > 1)
+    {
+        Rep *own = new Rep(rep->store);
+        release();
+        rep = own;
+    }
+
+    return rep->store;
+}
+
+template <class T, class Inner>
+void SharedStorage<T, Inner>::release()
+{
+    if (rep && --rep->refs == 0)
+        delete rep;
+    rep = NULL;
+}
@@ -0,0 +1,255 @@
+#ifndef ARRAYSTORAGE_H
+#define ARRAYSTORAGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "nodePool.h"
+using namespace std;
+
+/*
+Storage policies decide how the slots of an Array are laid out in memory.
+Every policy has to provide
+capacity()             number of slots
+slot(i)                pointer to the item in slot i or NULL if the slot is empty
+item(i)                pointer to the item in slot i without looking at occupancy, only for filled slots
+writableSlot(i)        like slot(i), but a storage that shares or maps its items gets its own copy first
+                       slot, item and data never copy, so they are for reading and for changes the storage does itself
+construct(i, args...) builds an item in the empty slot i from args (copy, move or emplace)
+destroy(i)             removes the item in slot i
+destroyAll()           empties every slot
+resize(capacity)       keeps the items that still fit, moving them instead of copying
+firstEmpty(limit)      lowest empty slot below limit or -1
+nextOccupied(from)     lowest filled slot from index from onwards or -1
+countOccupied()        number of filled slots
+CONTIGUOUS             true when the items sit next to each other behind data()
+*/
+
+// one bit per slot, set when the slot holds an item
+class Occupancy
+{
+public:
+    Occupancy(int length);
+    Occupancy(const Occupancy &copy);
+    Occupancy(Occupancy &&other);
+    ~Occupancy();
+
+    Occupancy &operator=(const Occupancy &rhs);
+    Occupancy &operator=(Occupancy &&rhs);
+
+    bool test(int i) const;
+    void set(int i);
+    void reset(int i);
+    void resetAll();
+    void setAll();
+    void resize(int length);
+
+    int findFirstUnset(int limit);
+    int findNextSet(int from) const;
+    int count() const;
+    uint64_t getWord(int w) const;
+    void setWord(int w, uint64_t bits);
+    int getLength() const;
+
+    static int wordsFor(int length);
+
+private:
+    void allocate();
+    void release();
+
+    uint64_t *words; // points at local while the bitmap fits in one word
+    uint64_t local;
+    int length;
+    int setBits;
+    // every bit below hint is set, so searches for a free slot start there
+    int hint;
+};
+
+// every item is allocated on its own, the original Array layout
+// Nodes is the allocator for the items (see nodePool.h)
+template <class T, class Nodes = HeapNodes<T>>
+class PointerStorage
+{
+public:
+    PointerStorage(int capacity);
+    PointerStorage(const PointerStorage<T, Nodes> &copy);
+    PointerStorage(PointerStorage<T, Nodes> &&other);
+    ~PointerStorage();
+
+    PointerStorage<T, Nodes> &operator=(const PointerStorage<T, Nodes> &rhs);
+    PointerStorage<T, Nodes> &operator=(PointerStorage<T, Nodes> &&rhs);
+
+    int capacity() const;
+    T *slot(int i);
+    const T *slot(int i) const;
+    T *item(int i);
+    const T *item(int i) const;
+    T *writableSlot(int i);
+
+    template <class... Args>
+    void construct(int i, Args &&...args);
+    void destroy(int i);
+    void destroyAll();
+    void resize(int capacity);
+
+    int firstEmpty(int limit);
+    int nextOccupied(int from) const;
+    int countOccupied() const;
+
+    static const bool CONTIGUOUS = false;
+
+private:
+    T **slots;
+    Occupancy occupancy;
+    Nodes nodes;
+    int cap;
+};
+
+// items are kept inline in one buffer, empty slots are tracked in a bitmap
+template <class T>
+class ContiguousStorage
+{
+public:
+    ContiguousStorage(int capacity);
+    ContiguousStorage(const ContiguousStorage<T> &copy);
+    ContiguousStorage(ContiguousStorage<T> &&other);
+    ~ContiguousStorage();
+
+    ContiguousStorage<T> &operator=(const ContiguousStorage<T> &rhs);
+    ContiguousStorage<T> &operator=(ContiguousStorage<T> &&rhs);
+
+    int capacity() const;
+    T *slot(int i);
+    const T *slot(int i) const;
+    T *item(int i);
+    const T *item(int i) const;
+    T *writableSlot(int i);
+    T *data();
+    const T *data() const;
+
+    template <class... Args>
+    void construct(int i, Args &&...args);
+    void destroy(int i);
+    void destroyAll();
+    void resize(int capacity);
+
+    int firstEmpty(int limit);
+    int nextOccupied(int from) const;
+    int countOccupied() const;
+    const Occupancy &getOccupancy() const;
+
+    static const bool CONTIGUOUS = true;
+
+private:
+    typedef typename aligned_storage<sizeof(T), alignof(T)>::type Cell;
+
+    Cell *buffer;
+    Occupancy occupancy;
+    int cap;
+};
+
+// like ContiguousStorage, but the first N items live inside the storage itself so short arrays never allocate
+// items move to the heap once the capacity goes past N, pointers to them only stay valid until then
+template <class T, int N = 4>
+class SmallStorage
+{
+public:
+    SmallStorage(int capacity);
+    SmallStorage(const SmallStorage<T, N> &copy);
+    SmallStorage(SmallStorage<T, N> &&other);
+    ~SmallStorage();
+
+    SmallStorage<T, N> &operator=(const SmallStorage<T, N> &rhs);
+    SmallStorage<T, N> &operator=(SmallStorage<T, N> &&rhs);
+
+    int capacity() const;
+    T *slot(int i);
+    const T *slot(int i) const;
+    T *item(int i);
+    const T *item(int i) const;
+    T *writableSlot(int i);
+    T *data();
+    const T *data() const;
+
+    template <class... Args>
+    void construct(int i, Args &&...args);
+    void destroy(int i);
+    void destroyAll();
+    void resize(int capacity);
+
+    int firstEmpty(int limit);
+    int nextOccupied(int from) const;
+    int countOccupied() const;
+    const Occupancy &getOccupancy() const;
+    bool isInline() const;
+
+    static const bool CONTIGUOUS = true;
+
+private:
+    typedef typename aligned_storage<sizeof(T), alignof(T)>::type Cell;
+
+    void take(SmallStorage<T, N> &other);
+
+    Cell local[N];
+    Cell *buffer; // local while cap is N
+    Occupancy occupancy;
+    int cap;
+};
+
+// copies share one Inner storage through a reference count, the first change gives a copy its own storage
+template <class T, class Inner = ContiguousStorage<T>>
+class SharedStorage
+{
+public:
+    SharedStorage(int capacity);
+    SharedStorage(const SharedStorage<T, Inner> &copy);
+    SharedStorage(SharedStorage<T, Inner> &&other);
+    ~SharedStorage();
+
+    SharedStorage<T, Inner> &operator=(const SharedStorage<T, Inner> &rhs);
+    SharedStorage<T, Inner> &operator=(SharedStorage<T, Inner> &&rhs);
+
+    int capacity() const;
+    T *slot(int i);
+    const T *slot(int i) const;
+    T *item(int i);
+    const T *item(int i) const;
+    T *writableSlot(int i);
+    T *data();
+    const T *data() const;
+
+    template <class... Args>
+    void construct(int i, Args &&...args);
+    void destroy(int i);
+    void destroyAll();
+    void resize(int capacity);
+
+    int firstEmpty(int limit);
+    int nextOccupied(int from) const;
+    int countOccupied() const;
+    const Occupancy &getOccupancy() const;
+    bool isShared() const;
+
+    static const bool CONTIGUOUS = Inner::CONTIGUOUS;
+
+private:
+    struct Rep
+    {
+        Rep(int capacity);
+        Rep(const Inner &copy);
+
+        Inner store;
+        atomic<int> refs;
+    };
+
+    Inner &detach();
+    void release();
+
+    Rep *rep; // NULL once moved from, which acts as an empty storage
+};
+
+#include "arrayStorage.cpp"
+
+#endif
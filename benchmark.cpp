@@ -0,0 +1,324 @@
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include "testing.h"
+#include "arrayAlgorithms.h"
+#include "concurrentArray.h"
+#include "scheduler.h"
+// benchmarks for the Array storage, run with make bench
+
+// gcc matches a free inlined into delete against the operator new that made the pointer and warns,
+// so the replaced deletes and new[] stay out of line
+#ifdef __GNUC__
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+// counted with relaxed increments, the parallel rows allocate from several threads
+static atomic<long> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    void *memory = malloc(size ? size : 1);
+    if (!memory)
+        throw bad_alloc();
+    return memory;
+}
+
+// the array forms are replaced too, so every delete frees memory from the matching new
+OUT_OF_LINE void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+OUT_OF_LINE void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+OUT_OF_LINE void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+OUT_OF_LINE void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+OUT_OF_LINE void operator delete[](void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+// fills, copies and clears an array over and over like the suites do with their fixtures
+template <class A>
+void churn(string name, int rounds, int items)
+{
+    allocations = 0;
+    clock_t start = clock();
+
+    A source(0);
+    A copy(0);
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int i = 0; i < items; i++)
+        {
+            source.insert(i);
+        }
+        copy = source;
+        source.setLength(1);
+        copy.setLength(1);
+    }
+
+    double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+    cout << left << setw(22) << name << ": " << allocations << " allocations, " << seconds << "s" << endl;
+}
+
+// builds and copies the short test name lists that every suite is given
+template <class A>
+void nameLists(string name, int rounds)
+{
+    allocations = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        A names(0);
+        names.insert("TC");
+        names.insert("==");
+        A copy(names);
+    }
+
+    cout << left << setw(22) << name << ": " << allocations << " allocations" << endl;
+}
+
+// compares two equal arrays, the worst case for operator==
+template <class A>
+void equality(string name, int items, int rounds)
+{
+    A lhs(0);
+    A rhs(0);
+    lhs.reserve(items);
+    rhs.reserve(items);
+    for (int i = 0; i < items; i++)
+    {
+        lhs.insert(i);
+        rhs.insert(i);
+    }
+
+    clock_t start = clock();
+    int equal = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        equal += lhs == rhs;
+    }
+
+    double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+    cout << left << setw(22) << name << ": " << equal << "/" << rounds << " equal, " << seconds << "s" << endl;
+}
+
+double wallSeconds(const timespec &start)
+{
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// throughput of the scans behind text compare, over two texts of chars that are equal or differ everywhere
+void scanning(int chars, int rounds)
+{
+    string text(chars, ' ');
+    for (int i = 0; i < chars; i++)
+    {
+        text[i] = 'a' + (i * 7) % 26;
+    }
+    string same(text);
+    string other(text);
+    for (int i = 0; i < chars; i++)
+    {
+        other[i] = text[i] + 1;
+    }
+
+    const char *names[3] = {"findMismatch", "findMismatchFromEnd", "findMatch"};
+    for (int scan = 0; scan < 3; scan++)
+    {
+        timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t found = 0;
+        for (int r = 0; r < rounds; r++)
+        {
+            if (scan == 0)
+                found += findMismatch(text.data(), same.data(), chars);
+            else if (scan == 1)
+                found += findMismatchFromEnd(text.data(), same.data(), chars);
+            else
+                found += findMatch(text.data(), other.data(), chars);
+            clobberMemory();
+        }
+        doNotOptimize(found);
+        double seconds = wallSeconds(start);
+        cout << left << setw(22) << names[scan] << ": " << double(chars) * rounds / seconds / 1e9 << " GB/s" << endl;
+    }
+}
+
+// diffs long outputs with a few scattered changes, once by char and once by line
+void diffing(int lines, int changes)
+{
+    string test, correct;
+    for (int i = 0; i < lines; i++)
+    {
+        string line = "row " + to_string(i) + " value " + to_string((i * 2654435761u) % 100000) + "\n";
+        test += line;
+        if (i % (lines / changes) == lines / changes / 2)
+            correct += "row " + to_string(i) + " changed\n";
+        else
+            correct += line;
+    }
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ContiguousArray<Edit> chars(0);
+    bool complete = diffText(test, correct, chars);
+    double seconds = wallSeconds(start);
+    cout << left << setw(22) << "diffText" << ": " << test.length() / seconds / 1e6 << " MB/s, " << chars.getLength() << " edits" << (complete ? "" : ", gave up") << endl;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Lines testLines = splitLines(test);
+    Lines correctLines = splitLines(correct);
+    ContiguousArray<Edit> script(0);
+    complete = diffLines(test, testLines, correct, correctLines, script);
+    seconds = wallSeconds(start);
+    cout << left << setw(22) << "splitLines + diffLines" << ": " << test.length() / seconds / 1e6 << " MB/s, " << script.getLength() << " edits" << (complete ? "" : ", gave up") << endl;
+}
+
+// sorts the same shuffled items with one thread and with 4
+void sorting(int items)
+{
+    ContiguousArray<int> shuffled(0);
+    shuffled.reserve(items);
+    for (int i = 0; i < items; i++)
+    {
+        shuffled.insert((int)((i * 2654435761u) % items));
+    }
+
+    // a fixed count, so the parallel row splits the work even on a machine with one core
+    int threads[2] = {1, 4};
+    for (int t = 0; t < 2; t++)
+    {
+        Parallel::setThreadCount(threads[t]);
+        ContiguousArray<int> array(shuffled);
+
+        timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        parallelSort(array);
+        double seconds = wallSeconds(start);
+        cout << left << setw(22) << (to_string(Parallel::getThreadCount()) + " thread(s)") << ": " << seconds << "s" << endl;
+    }
+    Parallel::setThreadCount(0);
+}
+
+// every thread appends its share of the items, once behind a mutex and once lock free
+void appending(int threads, int items)
+{
+    Parallel::setThreadCount(threads);
+    int share = items / threads;
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Array<int> locked(0);
+    mutex lock;
+    Parallel::forEachTask(threads, [&](int t)
+    {
+        for (int i = 0; i < share; i++)
+        {
+            lock_guard<mutex> guard(lock);
+            locked.insert(t * share + i);
+        }
+    });
+    cout << left << setw(22) << ("mutex, " + to_string(threads) + " thread(s)") << ": " << wallSeconds(start) << "s" << endl;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ConcurrentArray<int> concurrent;
+    Parallel::forEachTask(threads, [&](int t)
+    {
+        for (int i = 0; i < share; i++)
+        {
+            concurrent.insert(t * share + i);
+        }
+    });
+    cout << left << setw(22) << ("lock free, " + to_string(threads) + " thread(s)") << ": " << wallSeconds(start) << "s" << endl;
+
+    Parallel::setThreadCount(0);
+}
+
+// runs the same batch of small suites in process and in forked workers, the suite output is thrown away
+void scheduling(int suites)
+{
+    ostringstream sink;
+    streambuf *console = cout.rdbuf();
+    string names[3] = {"in process, 1 thread", "in process, all cores", "forked workers"};
+
+    // forked workers only exist where the scheduler can fork
+    for (int mode = 0; mode < (SCHEDULER_ISOLATED ? 3 : 2); mode++)
+    {
+        Testing<ContiguousArray<int>, ContiguousArray<int>> testing(ContiguousArray<int>(64), ContiguousArray<int>(64));
+        for (int i = 0; i < suites; i++)
+        {
+            testing.createTestSuite({EQUALS, TEXT_COMPARE}, "suite " + to_string(i), RUN_LATER);
+        }
+        Scheduler scheduler;
+        scheduler.add(testing);
+
+        timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        cout.rdbuf(sink.rdbuf());
+#if SCHEDULER_ISOLATED
+        if (mode == 2)
+            scheduler.runIsolated(0);
+        else
+#endif
+            scheduler.run(mode == 0 ? 1 : 0);
+        cout.rdbuf(console);
+        sink.str("");
+
+        cout << left << setw(22) << names[mode] << ": " << wallSeconds(start) << "s" << endl;
+    }
+}
+
+int main()
+{
+    cout << "Array churn (100 rounds of 10000 items)" << endl;
+    churn<Array<int>>("Array<int>", 100, 10000);
+    churn<PooledArray<int>>("PooledArray<int>", 100, 10000);
+    churn<ContiguousArray<int>>("ContiguousArray<int>", 100, 10000);
+
+    cout << "\nTest name lists (1000 lists of 2 names)" << endl;
+    nameLists<Array<string>>("Array<string>", 1000);
+    nameLists<TestNames>("TestNames", 1000);
+
+    cout << "\nArray equality (1000000 items, 20 rounds)" << endl;
+    equality<Array<int>>("Array<int>", 1000000, 20);
+    equality<ContiguousArray<int>>("ContiguousArray<int>", 1000000, 20);
+    equality<ContiguousArray<float>>("ContiguousArray<float>", 1000000, 20);
+
+    cout << "\nparallelSort (4000000 items)" << endl;
+    sorting(4000000);
+
+    cout << "\nConcurrent append (2000000 items)" << endl;
+    appending(1, 2000000);
+    appending(4, 2000000);
+
+    cout << "\nText scans (16000000 chars, 50 rounds)" << endl;
+    scanning(16000000, 50);
+
+    cout << "\nText diffs (200000 lines, 100 changed)" << endl;
+    diffing(200000, 100);
+
+    cout << "\nScheduled suites (5000 suites)" << endl;
+    scheduling(5000);
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "concurrentArray.h"
+
+template <class T>
+ConcurrentArray<T>::ConcurrentArray()
+{
+    for (int s = 0; s < MAX_SEGMENTS; s++)
+    {
+        segments[s].store(NULL, memory_order_relaxed);
+    }
+    next.store(0, memory_order_relaxed);
+}
+
+template <class T>
+ConcurrentArray<T>::~ConcurrentArray()
+{
+    int length = getLength();
+    for (int i = 0; i < length; i++)
+    {
+        Cell *c = cell(i);
+        if (c && c->state.load(memory_order_relaxed) == READY)
+            reinterpret_cast<T *>(&c->item)->~T();
+    }
+
+    for (int s = 0; s < MAX_SEGMENTS; s++)
+    {
+        delete[] segments[s].load(memory_order_relaxed);
+    }
+}
+
+template <class T>
+int ConcurrentArray<T>::insert(T item)
+{
+    return emplace(std::move(item));
+}
+
+template <class T>
+template <class... Args>
+int ConcurrentArray<T>::emplace(Args &&...args)
+{
+    int i = next.fetch_add(1, memory_order_relaxed);
+    if (i < 0 || segmentOf(i) >= MAX_SEGMENTS)
+        throw length_error("ConcurrentArray is full");
+
+    int s = segmentOf(i);
+    Cell *c = segment(s) + (i - (segmentSize(s) - FIRST_SEGMENT_SIZE));
+    try
+    {
+        new (&c->item) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        c->state.store(ABANDONED, memory_order_release);
+        throw;
+    }
+
+    // readers that see READY also see the finished item
+    c->state.store(READY, memory_order_release);
+    return i;
+}
+
+template <class T>
+const T *ConcurrentArray<T>::operator[](int i) const
+{
+    if (i < 0 || i >= getLength())
+        throw out_of_range("Out of range");
+
+    Cell *c = cell(i);
+    if (!c || c->state.load(memory_order_acquire) != READY)
+        return NULL;
+    return reinterpret_cast<const T *>(&c->item);
+}
+
+template <class T>
+int ConcurrentArray<T>::getLength() const
+{
+    int length = next.load(memory_order_acquire);
+    int limit = segmentSize(MAX_SEGMENTS) - FIRST_SEGMENT_SIZE;
+    return length < 0 || length > limit ? limit : length;
+}
+
+template <class T>
+template <class Storage>
+Array<T, Storage> ConcurrentArray<T>::snapshot() const
+{
+    int length = getLength();
+    Array<T, Storage> copy(0);
+    copy.reserve(length);
+
+    for (int i = 0; i < length; i++)
+    {
+        Cell *c = cell(i);
+        char state = c ? c->state.load(memory_order_acquire) : EMPTY;
+        if (state == EMPTY)
+            break;
+        if (state == READY)
+            copy.insertNewItem(*reinterpret_cast<const T *>(&c->item));
+    }
+
+    return copy;
+}
+
+template <class T>
+int ConcurrentArray<T>::segmentOf(int i)
+{
+    // segment s starts at FIRST_SEGMENT_SIZE * (2^s - 1)
+    unsigned int block = (unsigned int)i / FIRST_SEGMENT_SIZE + 1;
+    return 31 - __builtin_clz(block);
+}
+
+template <class T>
+int ConcurrentArray<T>::segmentSize(int segment)
+{
+    return FIRST_SEGMENT_SIZE << segment;
+}
+
+template <class T>
+typename ConcurrentArray<T>::Cell *ConcurrentArray<T>::cell(int i) const
+{
+    // NULL when the segment has not been allocated yet
+    int s = segmentOf(i);
+    Cell *cells = segments[s].load(memory_order_acquire);
+    return cells ? cells + (i - (segmentSize(s) - FIRST_SEGMENT_SIZE)) : NULL;
+}
+
+template <class T>
+typename ConcurrentArray<T>::Cell *ConcurrentArray<T>::segment(int s)
+{
+    Cell *cells = segments[s].load(memory_order_acquire);
+    if (cells)
+        return cells;
+
+    // threads that race for a new segment all allocate one, the loser frees its own
+    Cell *fresh = new Cell[segmentSize(s)];
+    for (int i = 0; i < segmentSize(s); i++)
+    {
+        fresh[i].state.store(EMPTY, memory_order_relaxed);
+    }
+
+    if (segments[s].compare_exchange_strong(cells, fresh, memory_order_acq_rel, memory_order_acquire))
+        return fresh;
+
+    delete[] fresh;
+    return cells;
+}
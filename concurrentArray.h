@@ -0,0 +1,71 @@
+#ifndef CONCURRENTARRAY_H
+#define CONCURRENTARRAY_H
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array.h"
+using namespace std;
+
+/*
+Append only array that many threads can add to at the same time without a lock
+an append claims its index with one atomic add, so it never waits on other threads
+items live in segments that double in size and never move, so pointers to them stay valid
+snapshot() copies the items that are already complete into a normal Array
+*/
+template <class T>
+class ConcurrentArray
+{
+public:
+    ConcurrentArray();
+    ~ConcurrentArray();
+
+    // the items are shared with the threads appending to it, so it can not be copied or moved
+    ConcurrentArray(const ConcurrentArray<T> &) = delete;
+    ConcurrentArray<T> &operator=(const ConcurrentArray<T> &) = delete;
+
+    // both return the index the item landed in
+    int insert(T item);
+    template <class... Args>
+    int emplace(Args &&...args);
+
+    // NULL while the item at i is still being built
+    const T *operator[](int i) const;
+
+    // number of claimed indexes, items may still be in flight
+    int getLength() const;
+    // every complete item in index order, stops at the first one still being built
+    template <class Storage = PointerStorage<T>>
+    Array<T, Storage> snapshot() const;
+
+    static const int FIRST_SEGMENT_SIZE = 64;
+    static const int MAX_SEGMENTS = 24;
+
+private:
+    enum State : char
+    {
+        EMPTY,
+        READY,
+        ABANDONED // the constructor threw, the index stays unused
+    };
+
+    struct Cell
+    {
+        typename aligned_storage<sizeof(T), alignof(T)>::type item;
+        atomic<char> state;
+    };
+
+    static int segmentOf(int i);
+    static int segmentSize(int segment);
+    Cell *cell(int i) const;
+    Cell *segment(int s);
+
+    atomic<Cell *> segments[MAX_SEGMENTS];
+    atomic<int> next;
+};
+
+#include "concurrentArray.cpp"
+
+#endif
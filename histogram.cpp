@@ -0,0 +1,115 @@
+#include "histogram.h"
+
+// ############################ Histogram code ############################
+inline Histogram::Histogram()
+{
+    count = 0;
+    min = 0;
+    max = 0;
+}
+
+inline void Histogram::record(long long value)
+{
+    if (value < 0)
+        value = 0;
+
+    int bucket = bucketOf(value);
+    if (bucket >= (int)counts.size())
+        counts.resize(bucket + 1, 0);
+    counts[bucket]++;
+
+    if (count == 0 || value < min)
+        min = value;
+    if (value > max)
+        max = value;
+    count++;
+}
+
+inline void Histogram::merge(const Histogram &other)
+{
+    if (other.count == 0)
+        return;
+
+    if (other.counts.size() > counts.size())
+        counts.resize(other.counts.size(), 0);
+    for (size_t i = 0; i < other.counts.size(); i++)
+    {
+        counts[i] += other.counts[i];
+    }
+
+    if (count == 0 || other.min < min)
+        min = other.min;
+    if (other.max > max)
+        max = other.max;
+    count += other.count;
+}
+
+inline long long Histogram::getCount() const
+{
+    return count;
+}
+
+inline long long Histogram::getMin() const
+{
+    return min;
+}
+
+inline long long Histogram::getMax() const
+{
+    return max;
+}
+
+inline long long Histogram::percentile(double percent) const
+{
+    if (count == 0)
+        return 0;
+
+    // the rank of the value asked for, counted from 1
+    long long rank = (long long)ceil(percent / 100 * count);
+    if (rank < 1)
+        rank = 1;
+
+    long long seen = 0;
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return highestIn(i) < max ? highestIn(i) : max;
+    }
+    return max;
+}
+
+inline int Histogram::bucketOf(long long value)
+{
+    if (value < SUB_BUCKETS)
+        return value;
+
+    // SUB_BUCKETS buckets for every power of two from SUB_BUCKETS up
+    int power = 63 - __builtin_clzll(value);
+    return SUB_BUCKETS * (power - SUB_BITS + 1) + (value >> (power - SUB_BITS)) - SUB_BUCKETS;
+}
+
+inline long long Histogram::highestIn(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    long long lowest = (long long)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lowest + (1ll << shift) - 1;
+}
+
+// ############################ helpers ############################
+inline string formatNanoseconds(double nanoseconds)
+{
+    char text[32];
+    if (nanoseconds < 999.5)
+        snprintf(text, sizeof(text), "%.3gns", nanoseconds);
+    else if (nanoseconds < 1000000)
+        snprintf(text, sizeof(text), "%.1fus", nanoseconds / 1e3);
+    else if (nanoseconds < 1000000000)
+        snprintf(text, sizeof(text), "%.1fms", nanoseconds / 1e6);
+    else
+        snprintf(text, sizeof(text), "%.2fs", nanoseconds / 1e9);
+    return text;
+}
@@ -0,0 +1,49 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+using namespace std;
+
+/*
+Latency histogram in the style of HdrHistogram
+a value is bucketed by its power of two and then by SUB_BUCKETS linear steps inside it,
+so every value is kept to within 1 / SUB_BUCKETS (about 3%) no matter how large it is
+recording is a few bit operations and the buckets only grow up to the largest value recorded
+*/
+class Histogram
+{
+public:
+    Histogram();
+
+    // negative values count as 0
+    void record(long long value);
+    void merge(const Histogram &other);
+
+    long long getCount() const;
+    long long getMin() const;
+    long long getMax() const;
+    // highest value that percent of the values are at or below, to the precision of the buckets, 0 when empty
+    long long percentile(double percent) const;
+
+    static const int SUB_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+
+private:
+    static int bucketOf(long long value);
+    static long long highestIn(int bucket);
+
+    vector<long long> counts;
+    long long count;
+    long long min;
+    long long max;
+};
+
+// 850ns, 1.25ns, 12.3us, 4.5ms or 1.23s
+string formatNanoseconds(double nanoseconds);
+
+#include "histogram.cpp"
+
+#endif
@@ -0,0 +1,240 @@
+#include "lineDiff.h"
+
+// ############################ Lines code ############################
+inline Lines::Lines() : starts(0), hashes(0)
+{
+}
+
+inline int Lines::count() const
+{
+    return hashes.getLength();
+}
+
+inline int Lines::begin(int line) const
+{
+    return *starts[line];
+}
+
+inline int Lines::length(int line) const
+{
+    return *starts[line + 1] - *starts[line] - 1;
+}
+
+inline Lines splitLines(const string &text)
+{
+    // the text is treated as ending in a newline, so a last line without one is still a line
+    Lines lines;
+    const char *data = text.data();
+    size_t at = 0;
+    while (at < text.length())
+    {
+        const char *newline = static_cast<const char *>(memchr(data + at, '\n', text.length() - at));
+        size_t end = newline ? newline - data : text.length();
+
+        lines.starts.insert(at);
+        lines.hashes.insert(hashLine(data + at, end - at));
+        at = end + 1;
+    }
+    lines.starts.insert(at);
+    return lines;
+}
+
+inline uint64_t hashLine(const char *text, size_t length)
+{
+    // 8 bytes at a time, mixed with a multiply and a rotate
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = length * prime;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, text + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, text + i, length - i);
+    hash = (hash ^ tail) * prime;
+    return hash ^ (hash >> 32);
+}
+
+// ############################ diff code ############################
+inline bool diffLines(const string &testText, const Lines &test, const string &correctText, const Lines &correct, ContiguousArray<Edit> &script, long long maxWork)
+{
+    const ContiguousArray<uint64_t> &testHashes = test.hashes;
+    const ContiguousArray<uint64_t> &correctHashes = correct.hashes;
+    const uint64_t *a = test.count() ? testHashes[0] : NULL;
+    const uint64_t *b = correct.count() ? correctHashes[0] : NULL;
+
+    bool complete = diffLineRange(a, 0, test.count(), b, 0, correct.count(), script, maxWork);
+    confirmEqualLines(testText, test, correctText, correct, script);
+    return complete;
+}
+
+inline void confirmEqualLines(const string &testText, const Lines &test, const string &correctText, const Lines &correct, ContiguousArray<Edit> &script)
+{
+    auto sameLine = [&](int t, int c)
+    {
+        int length = test.length(t);
+        return length == correct.length(c) && memcmp(testText.data() + test.begin(t), correctText.data() + correct.begin(c), length) == 0;
+    };
+
+    // nearly always every line matches, so the script is only rebuilt once a collision turns up
+    for (int e = 0; e < script.getLength(); e++)
+    {
+        const Edit &edit = *script[e];
+        if (edit.kind != EDIT_EQUAL)
+            continue;
+        for (int i = 0; i < edit.length; i++)
+        {
+            if (sameLine(edit.testBegin + i, edit.correctBegin + i))
+                continue;
+
+            ContiguousArray<Edit> confirmed(0);
+            confirmed.reserve(script.getLength() + 2);
+            for (int k = 0; k < script.getLength(); k++)
+            {
+                const Edit &old = *script[k];
+                if (old.kind != EDIT_EQUAL || k < e)
+                {
+                    addEdit(confirmed, old.kind, old.testBegin, old.correctBegin, old.length);
+                    continue;
+                }
+                int run = 0;
+                for (int j = 0; j < old.length; j++)
+                {
+                    int t = old.testBegin + j, c = old.correctBegin + j;
+                    if (sameLine(t, c))
+                    {
+                        run++;
+                        continue;
+                    }
+                    addEdit(confirmed, EDIT_EQUAL, t - run, c - run, run);
+                    addEdit(confirmed, EDIT_DELETE, t, c, 1);
+                    addEdit(confirmed, EDIT_INSERT, t + 1, c, 1);
+                    run = 0;
+                }
+                addEdit(confirmed, EDIT_EQUAL, old.testBegin + old.length - run, old.correctBegin + old.length - run, run);
+            }
+            script = std::move(confirmed);
+            return;
+        }
+    }
+}
+
+inline bool diffLineRange(const uint64_t *test, int testBegin, int testEnd, const uint64_t *correct, int correctBegin, int correctEnd, ContiguousArray<Edit> &script, long long maxWork)
+{
+    int prefix = commonPrefix(test + testBegin, correct + correctBegin, min(testEnd - testBegin, correctEnd - correctBegin));
+    addEdit(script, EDIT_EQUAL, testBegin, correctBegin, prefix);
+    testBegin += prefix;
+    correctBegin += prefix;
+
+    int length = min(testEnd - testBegin, correctEnd - correctBegin);
+    int suffix = commonSuffix(test + testEnd - length, correct + correctEnd - length, length);
+    testEnd -= suffix;
+    correctEnd -= suffix;
+
+    bool complete = true;
+    vector<pair<int, int>> anchors;
+    if (testBegin < testEnd && correctBegin < correctEnd)
+        uniqueAnchors(test, testBegin, testEnd, correct, correctBegin, correctEnd, anchors);
+
+    if (!anchors.empty())
+    {
+        // the gaps between anchors are diffed on their own, the anchors themselves are equal lines
+        int a = testBegin, b = correctBegin;
+        for (size_t i = 0; i < anchors.size(); i++)
+        {
+            complete = diffLineRange(test, a, anchors[i].first, correct, b, anchors[i].second, script, maxWork) && complete;
+            addEdit(script, EDIT_EQUAL, anchors[i].first, anchors[i].second, 1);
+            a = anchors[i].first + 1;
+            b = anchors[i].second + 1;
+        }
+        complete = diffLineRange(test, a, testEnd, correct, b, correctEnd, script, maxWork) && complete;
+    }
+    else if (testBegin < testEnd || correctBegin < correctEnd)
+    {
+        ContiguousArray<Edit> gap(0);
+        if (diffSequence(test + testBegin, testEnd - testBegin, correct + correctBegin, correctEnd - correctBegin, gap, maxWork))
+        {
+            for (int i = 0; i < gap.getLength(); i++)
+            {
+                addEdit(script, gap[i]->kind, gap[i]->testBegin + testBegin, gap[i]->correctBegin + correctBegin, gap[i]->length);
+            }
+        }
+        else
+        {
+            addEdit(script, EDIT_DELETE, testBegin, correctBegin, testEnd - testBegin);
+            addEdit(script, EDIT_INSERT, testEnd, correctBegin, correctEnd - correctBegin);
+            complete = false;
+        }
+    }
+
+    addEdit(script, EDIT_EQUAL, testEnd, correctEnd, suffix);
+    return complete;
+}
+
+inline void uniqueAnchors(const uint64_t *test, int testBegin, int testEnd, const uint64_t *correct, int correctBegin, int correctEnd, vector<pair<int, int>> &anchors)
+{
+    // lines that appear once on each side, then the longest run of them that is in the same order on both sides
+    struct Count
+    {
+        int test, correct;
+        int testAt, correctAt;
+    };
+    unordered_map<uint64_t, Count> counts;
+    counts.reserve(testEnd - testBegin);
+    for (int i = testBegin; i < testEnd; i++)
+    {
+        Count &count = counts[test[i]];
+        count.test++;
+        count.testAt = i;
+    }
+    for (int i = correctBegin; i < correctEnd; i++)
+    {
+        unordered_map<uint64_t, Count>::iterator found = counts.find(correct[i]);
+        if (found != counts.end())
+        {
+            found->second.correct++;
+            found->second.correctAt = i;
+        }
+    }
+
+    vector<pair<int, int>> unique;
+    for (int i = testBegin; i < testEnd; i++)
+    {
+        const Count &count = counts[test[i]];
+        if (count.test == 1 && count.correct == 1)
+            unique.push_back(make_pair(i, count.correctAt));
+    }
+
+    // patience sorting: piles[p] is the index in unique of the smallest correct line that ends a run of length p + 1
+    vector<int> piles;
+    vector<int> previous(unique.size(), -1);
+    for (size_t i = 0; i < unique.size(); i++)
+    {
+        int low = 0, high = piles.size();
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+            if (unique[piles[mid]].second < unique[i].second)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low > 0)
+            previous[i] = piles[low - 1];
+        if (low == (int)piles.size())
+            piles.push_back(i);
+        else
+            piles[low] = i;
+    }
+
+    anchors.clear();
+    for (int i = piles.empty() ? -1 : piles.back(); i != -1; i = previous[i])
+    {
+        anchors.push_back(unique[i]);
+    }
+    reverse(anchors.begin(), anchors.end());
+}
@@ -0,0 +1,54 @@
+#ifndef LINEDIFF_H
+#define LINEDIFF_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "textDiff.h"
+using namespace std;
+
+/*
+Line by line diff for large multi line output, used by lineCompare
+every line is hashed once and only the hashes are compared, lines the diff finds equal are checked once more against their text
+lines that appear exactly once on both sides are matched up first (patience diff) and the gaps between them are diffed again
+gaps without such lines fall back to the Myers diff in textDiff.h on the hashes
+*/
+
+// equal lines shown around every change, longer equal runs are cut short
+const int LINE_CONTEXT = 3;
+// work allowed for the char diff inside one changed line
+const long long LINE_PAIR_WORK = 1ll << 16;
+
+// where every line of a text starts and the hash of each, the last entry of starts is the end of the text
+struct Lines
+{
+    Lines();
+
+    ContiguousArray<int> starts;
+    ContiguousArray<uint64_t> hashes;
+
+    int count() const;
+    int begin(int line) const;
+    // without the newline
+    int length(int line) const;
+};
+
+Lines splitLines(const string &text);
+uint64_t hashLine(const char *text, size_t length);
+
+// fills script with line edits from test to correct, the lines of testText and correctText as split by splitLines
+// returns false when a gap was too different to diff within maxWork, such a gap is still written to script as deleted and inserted lines
+bool diffLines(const string &testText, const Lines &test, const string &correctText, const Lines &correct, ContiguousArray<Edit> &script, long long maxWork = DEFAULT_DIFF_WORK);
+
+// ######## helpers ########
+// splits every equal run of script where two lines only share their hash into a deleted and an inserted line
+void confirmEqualLines(const string &testText, const Lines &test, const string &correctText, const Lines &correct, ContiguousArray<Edit> &script);
+bool diffLineRange(const uint64_t *test, int testBegin, int testEnd, const uint64_t *correct, int correctBegin, int correctEnd, ContiguousArray<Edit> &script, long long maxWork);
+void uniqueAnchors(const uint64_t *test, int testBegin, int testEnd, const uint64_t *correct, int correctBegin, int correctEnd, vector<pair<int, int>> &anchors);
+
+#include "lineDiff.cpp"
+
+#endif
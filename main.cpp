@@ -1,16 +1,23 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include "testing.h"
+#include "scheduler.h"
+#include "arrayBinary.h"
 // ironically used to test the testing framework
 int main()
 {
-    Array<string> arrStr(1);
+    TestNames arrStr(0);
     arrStr.insert("TC");
     arrStr.insert("==");
+    // the names are parsed once, a typo throws here instead of inside a suite
+    TestPlan tests(arrStr);
 
     string test1 = ("107100");
     string test2 = ("109");
 
     // testing basic strings
-    Suite<string, string> suiteString(arrStr, test1, test2, "basic compare");
+    Suite<string, string> suiteString(tests, test1, test2, "basic compare");
 
     // testing the array class
     cout << "Array testing \n"
@@ -25,18 +32,122 @@ int main()
     cout << to_string(arr1) << endl;
     Array<int> arr2(10);
 
-    Suite<Array<int>, Array<int>> suiteArrBefore(arrStr, arr1, arr2, "Testing arrays in the suite");
+    Suite<Array<int>, Array<int>> suiteArrBefore(tests, arr1, arr2, "Testing arrays in the suite");
 
     arr2 = arr1;
 
     cout << to_string(arr2) << endl;
-    Suite<Array<int>, Array<int>> suiteArrAfter(arrStr, arr1, arr2, "Testing arrays in the Testing class");
+    Suite<Array<int>, Array<int>> suiteArrAfter(tests, arr1, arr2, "Testing arrays in the Testing class");
+
+    ContiguousArray<int> contArr1(5);
+    ContiguousArray<int> contArr2(5);
+    for (int i = 0; i < 5; i++)
+    {
+        contArr1.insertNewItem(i);
+        contArr2.insertNewItem(i);
+    }
+
+    Suite<ContiguousArray<int>, ContiguousArray<int>> suiteContArr(tests, contArr1, contArr2, "Testing contiguous arrays");
 
     Testing<string, string> *Ts = new Testing<string, string>(test1, test2);
-    Ts->createTestSuite(arrStr, "basic compare in TS object");
+    Ts->createTestSuite(tests, "basic compare in TS object");
 
     Testing<Array<int>, Array<int>> *TsArr = new Testing<Array<int>, Array<int>>(arr2, arr1);
-    TsArr->createTestSuite(arrStr, "Arr compare in TSarr object");
+    TsArr->createTestSuite(tests, "Arr compare in TSarr object");
+
+    // suites made with RUN_LATER only run once the scheduler runs its batch, here on 4 threads so the threaded path runs on any machine
+    Testing<ContiguousArray<int>, ContiguousArray<int>> deferred(contArr1, contArr2);
+    deferred.createTestSuite(tests, "deferred contiguous arrays", RUN_LATER);
+    Scheduler scheduler;
+    scheduler.add(deferred);
+    scheduler.run(4);
+    // totals of the Testing object with how long its tests took
+    deferred.printSummary();
+
+    // arrays saved with writeBinary come back mapped, a raw file of items is mapped with mapArray
+    writeBinary("driver_array.arrb", contArr1);
+    {
+        ofstream raw("driver_array.raw", ios::binary);
+        for (int i = 0; i < contArr1.getLength(); i++)
+            raw.write(reinterpret_cast<const char *>(contArr1[i]), sizeof(int));
+    }
+    MappedArray<int> loaded = readBinary<int>("driver_array.arrb");
+    Suite<MappedArray<int>, MappedArray<int>> suiteMapped(tests, loaded, mapArray<int>("driver_array.raw"), "binary round trip");
+    Suite<MappedArray<int>, MappedArray<int>> suiteConverted(tests, loaded, MappedArray<int>(contArr1), "mapped against converted");
+
+    // reading through [] leaves the file mapped, only a change through getIndex copies the items
+    int loadedSum = 0;
+    for (int i = 0; i < loaded.getLength(); i++)
+        loadedSum += loaded[i] ? *loaded[i] : 0;
+    if (loaded.getStorage().isMapped())
+        cout << GREEN << "Read " << loadedSum << " from the items that are still mapped" << RESET << endl;
+    else
+        cout << RED << "Reading the mapped array copied its items" << RESET << endl;
+
+    // files that are not a matching array are refused
+    try
+    {
+        readBinary<float>("driver_array.arrb");
+        cout << RED << "An int array was read as float" << RESET << endl;
+    }
+    catch (runtime_error &e)
+    {
+        cout << GREEN << "Refused: " << e.what() << RESET << endl;
+    }
+    try
+    {
+        readBinary<int>("driver_array.raw");
+        cout << RED << "A raw file was read as a binary array" << RESET << endl;
+    }
+    catch (runtime_error &e)
+    {
+        cout << GREEN << "Refused: " << e.what() << RESET << endl;
+    }
+    remove("driver_array.arrb");
+    remove("driver_array.raw");
+
+    // line compare only shows the changed lines of long output
+    string report1 = "header\nrow 1\nrow 2\nrow 3\nrow 4\nrow 5\nrow 6\nrow 7\ntotal 28\n";
+    string report2 = "header\nrow 1\nrow 2\nrow 3\nrow 4\nrow 5\nrow 6\nrow 7\nrow 8\ntotal 36\n";
+    Suite<string, string> suiteLines({LINE_COMPARE}, report1, report2, "line compare");
+
+    // with REPORT_FAILURES only failing tests print, so the passing suite says nothing at all
+    // the small flush size writes the buffer out between tests instead of once at the end
+    Report::setDetail(REPORT_FAILURES);
+    Report::setFlushSize(64);
+    Suite<string, string> suiteQuietPass(tests, test1, test1, "quiet passing suite");
+    Suite<string, string> suiteQuietFail(tests, test1, test2 + test1, "quiet failing suite");
+    Report::setDetail(REPORT_ALL);
+    Report::setFlushSize(1 << 16);
+
+    // an attached reporter gets every suite as structured events, here as TAP printed once the suites are done
+    {
+        ostringstream tapText;
+        TapReporter tap(tapText);
+        Reporter::attach(tap);
+        Suite<string, string> suiteTapPass(tests, test1, test1, "reported passing suite");
+        Testing<string, string> reported(test1, test2);
+        reported.createTestSuite(tests, "reported failing suite", RUN_LATER);
+        reported.createTestSuite(tests, "reported failing suite 2", RUN_LATER);
+        Scheduler reportedBatch;
+        reportedBatch.add(reported);
+        reportedBatch.run(4);
+        Reporter::detach(tap);
+        tap.finish();
+        cout << "\nTAP report\n"
+             << tapText.str() << endl;
+    }
+
+    // BM times a callable on the test object, here with a limit of 1ms per call
+    Suite<ContiguousArray<int>, ContiguousArray<int>> suiteBench({BENCHMARK}, contArr1, contArr2, "summing contiguous arrays", RUN_LATER);
+    suiteBench.setBenchmark([](ContiguousArray<int> &array)
+                            {
+        int sum = 0;
+        for (int i = 0; i < array.getLength(); i++)
+            sum += *array[i];
+        doNotOptimize(sum); },
+                            1000000);
+    suiteBench.run();
 
     delete Ts;
     delete TsArr;
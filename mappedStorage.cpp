@@ -0,0 +1,335 @@
+#include "mappedStorage.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+template <class T>
+MappedStorage<T>::MappedStorage(int capacity) : occupancy(capacity)
+{
+    items = static_cast<T *>(::operator new(capacity * sizeof(T)));
+    cap = capacity;
+    mapping = NULL;
+    mappedBytes = 0;
+    offset = 0;
+    mode = READ_ONLY;
+    written = false;
+}
+
+template <class T>
+MappedStorage<T>::MappedStorage(const string &path, Mode mode) : occupancy(0)
+{
+    items = NULL;
+    cap = 0;
+    mapping = NULL;
+    mappedBytes = 0;
+    written = false;
+
+    map(path, mode, 0, -1);
+    occupancy.resize(cap);
+    occupancy.setAll();
+}
+
+template <class T>
+MappedStorage<T>::MappedStorage(const string &path, Mode mode, size_t offset, Occupancy &&occupancy) : occupancy(std::move(occupancy))
+{
+    items = NULL;
+    cap = 0;
+    mapping = NULL;
+    mappedBytes = 0;
+    written = false;
+
+    map(path, mode, offset, this->occupancy.getLength());
+}
+
+template <class T>
+MappedStorage<T>::MappedStorage(const MappedStorage<T> &copy) : occupancy(copy.occupancy)
+{
+    items = NULL;
+    cap = 0;
+    mapping = NULL;
+    mappedBytes = 0;
+    offset = 0;
+    mode = copy.mode;
+    written = false;
+
+    // an untouched mapping is mapped again instead of copied
+    if (copy.mapping && !copy.written)
+        map(copy.path, copy.mode, copy.offset, copy.cap);
+    else
+    {
+        cap = copy.cap;
+        items = static_cast<T *>(::operator new(cap * sizeof(T)));
+        memcpy(items, copy.items, cap * sizeof(T));
+    }
+}
+
+template <class T>
+MappedStorage<T>::MappedStorage(MappedStorage<T> &&other) : occupancy(std::move(other.occupancy))
+{
+    items = other.items;
+    cap = other.cap;
+    mapping = other.mapping;
+    mappedBytes = other.mappedBytes;
+    path = std::move(other.path);
+    offset = other.offset;
+    mode = other.mode;
+    written = other.written;
+
+    other.items = NULL;
+    other.cap = 0;
+    other.mapping = NULL;
+    other.mappedBytes = 0;
+}
+
+template <class T>
+MappedStorage<T>::~MappedStorage()
+{
+    unmap();
+}
+
+template <class T>
+MappedStorage<T> &MappedStorage<T>::operator=(const MappedStorage<T> &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    MappedStorage<T> copy(rhs);
+    *this = std::move(copy);
+
+    return *this;
+}
+
+template <class T>
+MappedStorage<T> &MappedStorage<T>::operator=(MappedStorage<T> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    unmap();
+
+    items = rhs.items;
+    cap = rhs.cap;
+    occupancy = std::move(rhs.occupancy);
+    mapping = rhs.mapping;
+    mappedBytes = rhs.mappedBytes;
+    path = std::move(rhs.path);
+    offset = rhs.offset;
+    mode = rhs.mode;
+    written = rhs.written;
+
+    rhs.items = NULL;
+    rhs.cap = 0;
+    rhs.mapping = NULL;
+    rhs.mappedBytes = 0;
+
+    return *this;
+}
+
+template <class T>
+int MappedStorage<T>::capacity() const
+{
+    return cap;
+}
+
+template <class T>
+T *MappedStorage<T>::slot(int i)
+{
+    // reads stay on the mapping, writableSlot moves a read only mapping to the heap
+    return occupancy.test(i) ? items + i : NULL;
+}
+
+template <class T>
+const T *MappedStorage<T>::slot(int i) const
+{
+    return occupancy.test(i) ? items + i : NULL;
+}
+
+template <class T>
+T *MappedStorage<T>::item(int i)
+{
+    return items + i;
+}
+
+template <class T>
+const T *MappedStorage<T>::item(int i) const
+{
+    return items + i;
+}
+
+template <class T>
+T *MappedStorage<T>::writableSlot(int i)
+{
+    T *own = writable();
+    return occupancy.test(i) ? own + i : NULL;
+}
+
+template <class T>
+T *MappedStorage<T>::data()
+{
+    return items;
+}
+
+template <class T>
+const T *MappedStorage<T>::data() const
+{
+    return items;
+}
+
+template <class T>
+template <class... Args>
+void MappedStorage<T>::construct(int i, Args &&...args)
+{
+    new (writable() + i) T(std::forward<Args>(args)...);
+    occupancy.set(i);
+}
+
+template <class T>
+void MappedStorage<T>::destroy(int i)
+{
+    // trivially copyable items need no destructor call
+    occupancy.reset(i);
+}
+
+template <class T>
+void MappedStorage<T>::destroyAll()
+{
+    occupancy.resetAll();
+}
+
+template <class T>
+void MappedStorage<T>::resize(int capacity)
+{
+    own(capacity);
+    occupancy.resize(capacity);
+}
+
+template <class T>
+int MappedStorage<T>::firstEmpty(int limit)
+{
+    return occupancy.findFirstUnset(limit);
+}
+
+template <class T>
+int MappedStorage<T>::nextOccupied(int from) const
+{
+    return occupancy.findNextSet(from);
+}
+
+template <class T>
+int MappedStorage<T>::countOccupied() const
+{
+    return occupancy.count();
+}
+
+template <class T>
+const Occupancy &MappedStorage<T>::getOccupancy() const
+{
+    return occupancy;
+}
+
+template <class T>
+bool MappedStorage<T>::isMapped() const
+{
+    return mapping != NULL;
+}
+
+template <class T>
+void MappedStorage<T>::map(const string &path, Mode mode, size_t offset, int count)
+{
+    // count -1 maps every item from offset to the end of the file
+    this->path = path;
+    this->offset = offset;
+    this->mode = mode;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw runtime_error("Could not open " + path + " to map it");
+
+    struct stat info;
+    if (fstat(fd, &info) == -1)
+    {
+        close(fd);
+        throw runtime_error("Could not read the size of " + path);
+    }
+
+    size_t bytes = info.st_size;
+    if (offset > bytes || (count == -1 && (bytes - offset) % sizeof(T) != 0) || (count != -1 && (bytes - offset) / sizeof(T) < size_t(count)))
+    {
+        close(fd);
+        throw runtime_error(path + " does not hold a whole number of items");
+    }
+    if (count == -1)
+        count = (bytes - offset) / sizeof(T);
+
+    if (count > 0)
+    {
+        int protection = mode == READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+        int flags = mode == READ_ONLY ? MAP_SHARED : MAP_PRIVATE;
+        void *memory = mmap(NULL, bytes, protection, flags, fd, 0);
+        if (memory == MAP_FAILED)
+        {
+            close(fd);
+            throw runtime_error("Could not map " + path);
+        }
+
+        mapping = memory;
+        mappedBytes = bytes;
+        items = reinterpret_cast<T *>(static_cast<char *>(memory) + offset);
+    }
+    else
+        items = static_cast<T *>(::operator new(0));
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+    cap = count;
+}
+
+template <class T>
+void MappedStorage<T>::unmap()
+{
+    if (mapping)
+        munmap(mapping, mappedBytes);
+    else
+        ::operator delete(items);
+
+    items = NULL;
+    mapping = NULL;
+    mappedBytes = 0;
+}
+
+template <class T>
+void MappedStorage<T>::own(int capacity)
+{
+    // copies the items that fit onto the heap and drops the mapping
+    T *n_items = static_cast<T *>(::operator new(capacity * sizeof(T)));
+    if (items)
+        memcpy(n_items, items, (capacity < cap ? capacity : cap) * sizeof(T));
+
+    unmap();
+    items = n_items;
+    cap = capacity;
+    written = false;
+}
+
+template <class T>
+T *MappedStorage<T>::writable()
+{
+    if (mapping && mode == READ_ONLY)
+        own(cap);
+    else if (mapping)
+        written = true;
+
+    return items;
+}
+
+template <class T>
+MappedArray<T> mapArray(const string &path, typename MappedStorage<T>::Mode mode)
+{
+    return MappedArray<T>(MappedStorage<T>(path, mode));
+}
@@ -0,0 +1,91 @@
+#ifndef MAPPEDSTORAGE_H
+#define MAPPEDSTORAGE_H
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "array.h"
+using namespace std;
+
+/*
+Storage policy that maps a binary file of T items straight into memory, so huge fixtures are not loaded item by item
+READ_ONLY maps the file shared and read only, the first change through getIndex copies the items to the heap
+COPY_ON_WRITE maps the file privately, items can be changed in place without touching the file
+[] and iterators read the mapping without copying it
+growing the array always moves the items to the heap
+only for trivially copyable T, POSIX only
+*/
+template <class T>
+class MappedStorage
+{
+    static_assert(is_trivially_copyable<T>::value, "MappedStorage needs a trivially copyable item type");
+
+public:
+    enum Mode
+    {
+        READ_ONLY,
+        COPY_ON_WRITE
+    };
+
+    // a plain heap storage, used when the Array is made with a length
+    MappedStorage(int capacity);
+    MappedStorage(const string &path, Mode mode = READ_ONLY);
+    // maps the slots of occupancy starting offset bytes into the file, used by the binary format (see arrayBinary.h)
+    MappedStorage(const string &path, Mode mode, size_t offset, Occupancy &&occupancy);
+    MappedStorage(const MappedStorage<T> &copy);
+    MappedStorage(MappedStorage<T> &&other);
+    ~MappedStorage();
+
+    MappedStorage<T> &operator=(const MappedStorage<T> &rhs);
+    MappedStorage<T> &operator=(MappedStorage<T> &&rhs);
+
+    int capacity() const;
+    T *slot(int i);
+    const T *slot(int i) const;
+    T *item(int i);
+    const T *item(int i) const;
+    T *writableSlot(int i);
+    T *data();
+    const T *data() const;
+
+    template <class... Args>
+    void construct(int i, Args &&...args);
+    void destroy(int i);
+    void destroyAll();
+    void resize(int capacity);
+
+    int firstEmpty(int limit);
+    int nextOccupied(int from) const;
+    int countOccupied() const;
+    const Occupancy &getOccupancy() const;
+    bool isMapped() const;
+
+    static const bool CONTIGUOUS = true;
+
+private:
+    void map(const string &path, Mode mode, size_t offset, int count);
+    void unmap();
+    void own(int capacity);
+    T *writable();
+
+    T *items;
+    int cap;
+    Occupancy occupancy;
+
+    void *mapping; // NULL once the items live on the heap
+    size_t mappedBytes;
+    string path;
+    size_t offset; // of the first item in the file
+    Mode mode;
+    bool written; // a COPY_ON_WRITE mapping that has been changed can not be mapped again for a copy
+};
+
+template <class T>
+using MappedArray = Array<T, MappedStorage<T>>;
+
+template <class T>
+MappedArray<T> mapArray(const string &path, typename MappedStorage<T>::Mode mode = MappedStorage<T>::READ_ONLY);
+
+#include "mappedStorage.cpp"
+
+#endif
@@ -0,0 +1,162 @@
+#include "microbenchmark.h"
+
+// ############################ escapes ############################
+template <class T>
+void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+// ############################ settings ############################
+inline long long &Microbenchmark::warmup()
+{
+    static long long nanoseconds = 10000000;
+    return nanoseconds;
+}
+
+inline long long &Microbenchmark::sampleTime()
+{
+    static long long nanoseconds = 1000000;
+    return nanoseconds;
+}
+
+inline int &Microbenchmark::samples()
+{
+    static int count = 30;
+    return count;
+}
+
+inline long long &Microbenchmark::timeLimit()
+{
+    static long long nanoseconds = 1000000000;
+    return nanoseconds;
+}
+
+inline long long Microbenchmark::getWarmup()
+{
+    return warmup();
+}
+
+inline void Microbenchmark::setWarmup(long long nanoseconds)
+{
+    warmup() = nanoseconds > 0 ? nanoseconds : 0;
+}
+
+inline long long Microbenchmark::getSampleTime()
+{
+    return sampleTime();
+}
+
+inline void Microbenchmark::setSampleTime(long long nanoseconds)
+{
+    sampleTime() = nanoseconds > 1 ? nanoseconds : 1;
+}
+
+inline int Microbenchmark::getSamples()
+{
+    return samples();
+}
+
+inline void Microbenchmark::setSamples(int count)
+{
+    samples() = count > MIN_SAMPLES ? count : MIN_SAMPLES;
+}
+
+inline long long Microbenchmark::getTimeLimit()
+{
+    return timeLimit();
+}
+
+inline void Microbenchmark::setTimeLimit(long long nanoseconds)
+{
+    timeLimit() = nanoseconds > 0 ? nanoseconds : 0;
+}
+
+// ############################ Microbenchmark code ############################
+template <class Body>
+BenchmarkStats Microbenchmark::measure(Body body)
+{
+    // warmup: grow the batch until it takes a whole sample, and keep running it until the warmup time is used up
+    long long iterations = 1;
+    long long batch = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (true)
+    {
+        batch = runBatch(body, iterations);
+        // a body the compiler removed never fills a sample, so the batch stops growing somewhere
+        bool calibrated = batch >= sampleTime() || iterations >= MAX_ITERATIONS;
+        if (calibrated && chrono::steady_clock::now() - start >= chrono::nanoseconds(warmup()))
+            break;
+        if (!calibrated)
+            iterations *= 2;
+    }
+
+    int count = samples();
+    if (batch > 0 && timeLimit() / batch < count)
+        count = max((int)(timeLimit() / batch), (int)MIN_SAMPLES);
+
+    vector<double> times;
+    times.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        times.push_back((double)runBatch(body, iterations) / iterations);
+    }
+
+    BenchmarkStats stats;
+    stats.iterations = iterations;
+    summarize(times, stats);
+    return stats;
+}
+
+template <class Body>
+long long Microbenchmark::runBatch(Body &body, long long iterations)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; i++)
+    {
+        body();
+    }
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
+inline void Microbenchmark::summarize(vector<double> &times, BenchmarkStats &stats)
+{
+    sort(times.begin(), times.end());
+    int count = times.size();
+    double low = times[count / 4];
+    double high = times[(3 * count) / 4];
+    double fence = 1.5 * (high - low);
+
+    vector<double> kept;
+    kept.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        if (times[i] >= low - fence && times[i] <= high + fence)
+            kept.push_back(times[i]);
+    }
+
+    int size = kept.size();
+    double sum = 0;
+    for (int i = 0; i < size; i++)
+    {
+        sum += kept[i];
+    }
+    double mean = sum / size;
+
+    double squares = 0;
+    for (int i = 0; i < size; i++)
+    {
+        squares += (kept[i] - mean) * (kept[i] - mean);
+    }
+
+    stats.samples = size;
+    stats.rejected = count - size;
+    stats.mean = mean;
+    stats.median = size % 2 ? kept[size / 2] : (kept[size / 2 - 1] + kept[size / 2]) / 2;
+    stats.stddev = size > 1 ? sqrt(squares / (size - 1)) : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+/*
+Times a small piece of code the way the benchmark test kind (BM) runs it
+the body runs in batches, the batch size is doubled during warmup until one batch takes the sample time
+the batches after that are the samples, samples outside 1.5 times the interquartile range are dropped as outliers (Tukey fences)
+all results are nanoseconds per call of the body
+the body should pass what it computes to doNotOptimize, or the compiler may drop the work
+*/
+
+// keeps value alive as far as the compiler can tell, so the work that made it has to be done (GCC and Clang)
+template <class T>
+void doNotOptimize(const T &value);
+// makes the compiler assume all memory was read and written, so pending stores have to happen
+void clobberMemory();
+
+struct BenchmarkStats
+{
+    long long iterations; // calls of the body in one sample
+    int samples;          // samples kept
+    int rejected;         // samples dropped as outliers
+    double mean;
+    double median;
+    double stddev;
+};
+
+class Microbenchmark
+{
+public:
+    template <class Body>
+    static BenchmarkStats measure(Body body);
+
+    static long long getWarmup();
+    static void setWarmup(long long nanoseconds);
+    static long long getSampleTime();
+    static void setSampleTime(long long nanoseconds);
+    static int getSamples();
+    static void setSamples(int samples);
+    // slow bodies take fewer samples so one benchmark stays near this, but never fewer than MIN_SAMPLES
+    static long long getTimeLimit();
+    static void setTimeLimit(long long nanoseconds);
+
+    static const int MIN_SAMPLES = 5;
+    static const long long MAX_ITERATIONS = 1ll << 40;
+
+private:
+    template <class Body>
+    static long long runBatch(Body &body, long long iterations);
+    static void summarize(vector<double> &samples, BenchmarkStats &stats);
+
+    static long long &warmup();
+    static long long &sampleTime();
+    static int &samples();
+    static long long &timeLimit();
+};
+
+#include "microbenchmark.cpp"
+
+#endif
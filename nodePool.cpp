@@ -0,0 +1,183 @@
+#include "nodePool.h"
+
+// ############################ HeapNodes code ############################
+template <class T>
+template <class... Args>
+T *HeapNodes<T>::create(Args &&...args)
+{
+    return new T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void HeapNodes<T>::release(T *item)
+{
+    delete item;
+}
+
+template <class T>
+void HeapNodes<T>::reset()
+{
+}
+
+// ############################ SlabPool code ############################
+template <class T>
+SlabPool<T>::SlabPool()
+{
+    first = NULL;
+    last = NULL;
+    current = NULL;
+    used = 0;
+    freeList = NULL;
+    slabCount = 0;
+}
+
+template <class T>
+SlabPool<T>::SlabPool(SlabPool<T> &&other)
+{
+    first = other.first;
+    last = other.last;
+    current = other.current;
+    used = other.used;
+    freeList = other.freeList;
+    slabCount = other.slabCount;
+
+    other.first = NULL;
+    other.last = NULL;
+    other.current = NULL;
+    other.used = 0;
+    other.freeList = NULL;
+    other.slabCount = 0;
+}
+
+template <class T>
+SlabPool<T>::~SlabPool()
+{
+    freeSlabs();
+}
+
+template <class T>
+SlabPool<T> &SlabPool<T>::operator=(SlabPool<T> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    freeSlabs();
+
+    first = rhs.first;
+    last = rhs.last;
+    current = rhs.current;
+    used = rhs.used;
+    freeList = rhs.freeList;
+    slabCount = rhs.slabCount;
+
+    rhs.first = NULL;
+    rhs.last = NULL;
+    rhs.current = NULL;
+    rhs.used = 0;
+    rhs.freeList = NULL;
+    rhs.slabCount = 0;
+
+    return *this;
+}
+
+template <class T>
+template <class... Args>
+T *SlabPool<T>::create(Args &&...args)
+{
+    Node *node = takeNode();
+
+    try
+    {
+        return new (&node->item) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        node->next = freeList;
+        freeList = node;
+        throw;
+    }
+}
+
+template <class T>
+void SlabPool<T>::release(T *item)
+{
+    item->~T();
+
+    Node *node = reinterpret_cast<Node *>(item);
+    node->next = freeList;
+    freeList = node;
+}
+
+template <class T>
+void SlabPool<T>::reset()
+{
+    // every slab is reused from the start, nothing is given back to the heap
+    freeList = NULL;
+    current = first;
+    used = 0;
+}
+
+template <class T>
+int SlabPool<T>::getSlabCount() const
+{
+    return slabCount;
+}
+
+template <class T>
+typename SlabPool<T>::Node *SlabPool<T>::takeNode()
+{
+    if (freeList)
+    {
+        Node *node = freeList;
+        freeList = node->next;
+        return node;
+    }
+
+    while (current && used == current->size)
+    {
+        current = current->next;
+        used = 0;
+    }
+
+    if (!current)
+    {
+        Slab *slab = new Slab;
+        slab->size = last ? last->size * 2 : FIRST_SLAB_SIZE;
+        if (slab->size > MAX_SLAB_SIZE)
+            slab->size = MAX_SLAB_SIZE;
+        slab->nodes = new Node[slab->size];
+        slab->next = NULL;
+
+        if (last)
+            last->next = slab;
+        else
+            first = slab;
+        last = slab;
+        slabCount++;
+
+        current = slab;
+        used = 0;
+    }
+
+    return &current->nodes[used++];
+}
+
+template <class T>
+void SlabPool<T>::freeSlabs()
+{
+    while (first)
+    {
+        Slab *next = first->next;
+        delete[] first->nodes;
+        delete first;
+        first = next;
+    }
+
+    last = NULL;
+    current = NULL;
+    used = 0;
+    freeList = NULL;
+    slabCount = 0;
+}
@@ -0,0 +1,79 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <new>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+/*
+Node allocators hand out the memory for the items of a PointerStorage.
+Every allocator has to provide
+create(args...)    builds a new item and returns a pointer to it
+release(item)      destroys the item and gives its memory back
+reset()            called once every item has been released, memory may be reused in bulk
+*/
+
+// plain new and delete for every item
+template <class T>
+class HeapNodes
+{
+public:
+    template <class... Args>
+    T *create(Args &&...args);
+    void release(T *item);
+    void reset();
+};
+
+// carves items out of slabs that double in size, memory only goes back to the heap when the pool dies
+template <class T>
+class SlabPool
+{
+public:
+    SlabPool();
+    SlabPool(SlabPool<T> &&other);
+    ~SlabPool();
+
+    // a pool owns the memory of its items so it can not be copied
+    SlabPool(const SlabPool<T> &) = delete;
+    SlabPool<T> &operator=(const SlabPool<T> &) = delete;
+    SlabPool<T> &operator=(SlabPool<T> &&rhs);
+
+    template <class... Args>
+    T *create(Args &&...args);
+    void release(T *item);
+    void reset();
+
+    int getSlabCount() const;
+
+    static const int FIRST_SLAB_SIZE = 16;
+    static const int MAX_SLAB_SIZE = 4096;
+
+private:
+    union Node
+    {
+        Node *next;
+        typename aligned_storage<sizeof(T), alignof(T)>::type item;
+    };
+
+    struct Slab
+    {
+        Slab *next;
+        Node *nodes;
+        int size;
+    };
+
+    Node *takeNode();
+    void freeSlabs();
+
+    Slab *first;
+    Slab *last;
+    Slab *current; // slab that fresh nodes are carved from
+    int used;      // nodes of current already handed out
+    Node *freeList;
+    int slabCount;
+};
+
+#include "nodePool.cpp"
+
+#endif
@@ -0,0 +1,143 @@
+#include "report.h"
+
+// ############################ settings ############################
+inline string &Report::threadBuffer()
+{
+    static thread_local string buffer;
+    return buffer;
+}
+
+inline ReportDetail &Report::detail()
+{
+    static ReportDetail level = REPORT_ALL;
+    return level;
+}
+
+inline size_t &Report::flushSize()
+{
+    static size_t bytes = 1 << 16;
+    return bytes;
+}
+
+inline ReportDetail Report::getDetail()
+{
+    return detail();
+}
+
+inline void Report::setDetail(ReportDetail level)
+{
+    detail() = level;
+}
+
+inline size_t Report::getFlushSize()
+{
+    return flushSize();
+}
+
+inline void Report::setFlushSize(size_t bytes)
+{
+    flushSize() = bytes;
+}
+
+// ############################ Report code ############################
+inline Report::Report()
+{
+    target = &cout;
+    buffer = NULL;
+    start = 0;
+    written = 0;
+}
+
+inline Report::~Report()
+{
+    close();
+}
+
+inline void Report::open(ostream &target)
+{
+    close();
+    this->target = &target;
+    // a report opened while another one on this thread is still open starts after its output
+    buffer = &threadBuffer();
+    start = buffer->length();
+    written = 0;
+}
+
+inline void Report::close()
+{
+    if (!buffer)
+        return;
+
+    write();
+    target->flush();
+    buffer = NULL;
+    target = &cout;
+}
+
+inline bool Report::isOpen() const
+{
+    return buffer != NULL;
+}
+
+inline Report &Report::operator<<(const string &text)
+{
+    if (buffer)
+        buffer->append(text);
+    else
+        *target << text;
+    return *this;
+}
+
+inline Report &Report::operator<<(const char *text)
+{
+    if (buffer)
+        buffer->append(text);
+    else
+        *target << text;
+    return *this;
+}
+
+inline Report &Report::operator<<(char c)
+{
+    if (buffer)
+        buffer->push_back(c);
+    else
+        *target << c;
+    return *this;
+}
+
+inline Report &Report::operator<<(int value)
+{
+    return *this << to_string(value);
+}
+
+inline Report &Report::operator<<(long long value)
+{
+    return *this << to_string(value);
+}
+
+inline size_t Report::mark() const
+{
+    return buffer ? written + buffer->length() - start : 0;
+}
+
+inline void Report::drop(size_t mark)
+{
+    if (buffer && mark >= written)
+        buffer->resize(start + mark - written);
+}
+
+inline void Report::flush()
+{
+    if (buffer && buffer->length() - start >= flushSize())
+        write();
+}
+
+inline void Report::write()
+{
+    // one write for everything waiting, the memory stays with the thread for the next report
+    size_t waiting = buffer->length() - start;
+    target->write(buffer->data() + start, waiting);
+    buffer->resize(start);
+    written += waiting;
+}
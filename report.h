@@ -0,0 +1,69 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+using namespace std;
+
+// how much a suite reports, REPORT_FAILURES drops the output of every test that passed
+enum ReportDetail
+{
+    REPORT_ALL,
+    REPORT_FAILURES
+};
+
+/*
+Collects the output of a running suite and writes it to the target stream in one go
+the buffer belongs to the thread and keeps its memory between suites, so reporting stops allocating once it has grown
+an open report only writes when it is closed or when flush() finds more than the flush size waiting
+a closed report writes straight to its target, which is cout
+*/
+class Report
+{
+public:
+    Report();
+    ~Report();
+
+    // a report points into the buffer of its thread so it can not be copied
+    Report(const Report &) = delete;
+    Report &operator=(const Report &) = delete;
+
+    void open(ostream &target);
+    // writes whatever is left and flushes the target
+    void close();
+    bool isOpen() const;
+
+    Report &operator<<(const string &text);
+    Report &operator<<(const char *text);
+    Report &operator<<(char c);
+    Report &operator<<(int value);
+    Report &operator<<(long long value);
+
+    // position in the output, drop(mark) removes everything after it that has not been written yet
+    size_t mark() const;
+    void drop(size_t mark);
+    // writes the waiting output once it is past the flush size
+    void flush();
+
+    static ReportDetail getDetail();
+    static void setDetail(ReportDetail detail);
+    static size_t getFlushSize();
+    static void setFlushSize(size_t bytes);
+
+private:
+    void write();
+
+    static string &threadBuffer();
+    static ReportDetail &detail();
+    static size_t &flushSize();
+
+    ostream *target;
+    string *buffer; // NULL while closed
+    size_t start;   // where this report begins in buffer
+    size_t written; // bytes already given to target
+};
+
+#include "report.cpp"
+
+#endif
@@ -0,0 +1,310 @@
+#include "reporter.h"
+
+inline SuiteEvents::SuiteEvents() : tests(0)
+{
+}
+
+// ############################ Reporter code ############################
+inline Reporter::~Reporter()
+{
+}
+
+inline void Reporter::finish()
+{
+}
+
+inline vector<SuiteEvents> *&Reporter::captured()
+{
+    static thread_local vector<SuiteEvents> *events = NULL;
+    return events;
+}
+
+inline vector<Reporter *> &Reporter::attached()
+{
+    static vector<Reporter *> reporters;
+    return reporters;
+}
+
+inline mutex &Reporter::lock()
+{
+    static mutex reporters;
+    return reporters;
+}
+
+inline atomic<int> &Reporter::attachedCount()
+{
+    static atomic<int> count(0);
+    return count;
+}
+
+inline void Reporter::attach(Reporter &reporter)
+{
+    lock_guard<mutex> guard(lock());
+    attached().push_back(&reporter);
+    attachedCount()++;
+}
+
+inline void Reporter::detach(Reporter &reporter)
+{
+    lock_guard<mutex> guard(lock());
+    vector<Reporter *> &reporters = attached();
+    for (size_t i = 0; i < reporters.size(); i++)
+    {
+        if (reporters[i] == &reporter)
+        {
+            reporters.erase(reporters.begin() + i);
+            attachedCount()--;
+            return;
+        }
+    }
+}
+
+inline bool Reporter::isAttached()
+{
+    return attachedCount() > 0 || captured() != NULL;
+}
+
+inline void Reporter::publish(const SuiteResult &suite, const TestResult *tests, int count)
+{
+    if (captured())
+    {
+        SuiteEvents events;
+        events.suite = suite;
+        events.tests.reserve(count);
+        for (int i = 0; i < count; i++)
+        {
+            events.tests.insert(tests[i]);
+        }
+        captured()->push_back(std::move(events));
+        return;
+    }
+
+    lock_guard<mutex> guard(lock());
+    vector<Reporter *> &reporters = attached();
+    for (size_t r = 0; r < reporters.size(); r++)
+    {
+        reporters[r]->suiteStarted(suite);
+        for (int i = 0; i < count; i++)
+        {
+            reporters[r]->testFinished(suite, tests[i]);
+        }
+        reporters[r]->suiteFinished(suite);
+    }
+}
+
+inline void Reporter::capture(vector<SuiteEvents> *events)
+{
+    captured() = events;
+}
+
+inline void Reporter::replay(const vector<SuiteEvents> &events)
+{
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const ContiguousArray<TestResult> &tests = events[i].tests;
+        publish(events[i].suite, tests.getLength() ? tests[0] : NULL, tests.getLength());
+    }
+}
+
+inline void Reporter::detachInChild()
+{
+    // the list itself is left alone, with the count at 0 no suite publishes
+    attachedCount() = 0;
+    captured() = NULL;
+}
+
+// ############################ JUnitReporter code ############################
+inline JUnitReporter::JUnitReporter(ostream &out) : out(out)
+{
+    finished = false;
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+}
+
+inline JUnitReporter::~JUnitReporter()
+{
+    finish();
+}
+
+inline void JUnitReporter::suiteStarted(const SuiteResult &suite)
+{
+    out << "  <testsuite name=\"" << escapeXml(suite.suite) << "\" tests=\"" << suite.passes + suite.fails
+        << "\" failures=\"" << suite.fails << "\" errors=\"0\" time=\"" << formatSeconds(suite.nanoseconds) << "\">\n";
+}
+
+inline void JUnitReporter::testFinished(const SuiteResult &suite, const TestResult &test)
+{
+    out << "    <testcase classname=\"" << escapeXml(suite.suite) << "\" name=\"" << escapeXml(test.test)
+        << "\" time=\"" << formatSeconds(test.nanoseconds) << "\"";
+    if (test.passed)
+        out << "/>\n";
+    else
+        out << ">\n      <failure message=\"" << escapeXml(test.summary) << "\"/>\n    </testcase>\n";
+}
+
+inline void JUnitReporter::suiteFinished(const SuiteResult &)
+{
+    out << "  </testsuite>\n";
+}
+
+inline void JUnitReporter::finish()
+{
+    if (finished)
+        return;
+    finished = true;
+    out << "</testsuites>\n";
+    out.flush();
+}
+
+// ############################ JsonLinesReporter code ############################
+inline JsonLinesReporter::JsonLinesReporter(ostream &out) : out(out)
+{
+}
+
+inline void JsonLinesReporter::suiteStarted(const SuiteResult &suite)
+{
+    out << "{\"event\":\"suite_start\",\"suite\":\"" << escapeJson(suite.suite) << "\"}\n";
+}
+
+inline void JsonLinesReporter::testFinished(const SuiteResult &suite, const TestResult &test)
+{
+    out << "{\"event\":\"test\",\"suite\":\"" << escapeJson(suite.suite) << "\",\"test\":\"" << escapeJson(test.test)
+        << "\",\"passed\":" << (test.passed ? "true" : "false") << ",\"nanoseconds\":" << test.nanoseconds;
+    if (!test.passed)
+        out << ",\"summary\":\"" << escapeJson(test.summary) << "\"";
+    out << "}\n";
+}
+
+inline void JsonLinesReporter::suiteFinished(const SuiteResult &suite)
+{
+    out << "{\"event\":\"suite_end\",\"suite\":\"" << escapeJson(suite.suite) << "\",\"passes\":" << suite.passes
+        << ",\"fails\":" << suite.fails << ",\"nanoseconds\":" << suite.nanoseconds << "}\n";
+}
+
+// ############################ TapReporter code ############################
+inline TapReporter::TapReporter(ostream &out) : out(out)
+{
+    tests = 0;
+    finished = false;
+    out << "TAP version 13\n";
+}
+
+inline TapReporter::~TapReporter()
+{
+    finish();
+}
+
+inline void TapReporter::suiteStarted(const SuiteResult &suite)
+{
+    out << "# " << escapeTap(suite.suite) << "\n";
+}
+
+inline void TapReporter::testFinished(const SuiteResult &suite, const TestResult &test)
+{
+    tests++;
+    // a # in the description would start a TAP directive
+    string description = escapeTap(suite.suite + " " + test.test);
+    for (size_t at = description.find('#'); at != string::npos; at = description.find('#', at + 2))
+    {
+        description.insert(at, 1, '\\');
+    }
+    out << (test.passed ? "ok " : "not ok ") << tests << " - " << description << "\n";
+    if (!test.passed)
+        out << "  ---\n  message: \"" << escapeJson(test.summary) << "\"\n  ...\n";
+}
+
+inline void TapReporter::suiteFinished(const SuiteResult &)
+{
+}
+
+inline void TapReporter::finish()
+{
+    if (finished)
+        return;
+    finished = true;
+    out << "1.." << tests << "\n";
+    out.flush();
+}
+
+// ############################ helpers ############################
+inline string escapeXml(const string &text)
+{
+    string escaped;
+    escaped.reserve(text.length());
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        switch (text[i])
+        {
+        case '&':
+            escaped += "&amp;";
+            break;
+        case '<':
+            escaped += "&lt;";
+            break;
+        case '>':
+            escaped += "&gt;";
+            break;
+        case '"':
+            escaped += "&quot;";
+            break;
+        case '\'':
+            escaped += "&apos;";
+            break;
+        default:
+            // control chars other than tab and newlines are not allowed in XML 1.0
+            if ((unsigned char)text[i] >= 0x20 || text[i] == '\t' || text[i] == '\n' || text[i] == '\r')
+                escaped += text[i];
+        }
+    }
+    return escaped;
+}
+
+inline string escapeJson(const string &text)
+{
+    string escaped;
+    escaped.reserve(text.length());
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        unsigned char c = text[i];
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '\t')
+            escaped += "\\t";
+        else if (c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+inline string escapeTap(const string &text)
+{
+    string escaped;
+    escaped.reserve(text.length());
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        if (text[i] == '\n')
+            escaped += "\\n";
+        else if (text[i] == '\r')
+            escaped += "\\r";
+        else
+            escaped += text[i];
+    }
+    return escaped;
+}
+
+inline string formatSeconds(long long nanoseconds)
+{
+    char seconds[32];
+    snprintf(seconds, sizeof(seconds), "%.6f", nanoseconds / 1e9);
+    return seconds;
+}
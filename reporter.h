@@ -0,0 +1,139 @@
+#ifndef REPORTER_H
+#define REPORTER_H
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "array.h"
+using namespace std;
+
+/*
+Reporters get the results of every suite as structured events, next to the coloured text of report.h
+the events of one suite are handed over together once the suite is done, so suiteStarted already knows the totals
+and the events of suites running on different threads never mix
+a reporter writes as the events come in and only keeps counters, so it does not grow with the number of results
+Scheduler::run(threads) captures the events of every suite and publishes them in batch order, so the documents match a run on one thread
+Scheduler::runIsolated does the same across processes, the workers drop their reporters after the fork and send their captured events back
+a suite that throws is reported as failing on the test that threw, one that crashes or times out in a worker as failing on a test called run
+*/
+
+// one test of a suite
+struct TestResult
+{
+    string test; // the name from TEST_NAMES
+    bool passed;
+    long long nanoseconds;
+    string summary; // what went wrong, empty when the test passed
+};
+
+// a whole suite
+struct SuiteResult
+{
+    string suite;
+    int passes;
+    int fails;
+    long long nanoseconds;
+};
+
+// the events of one suite, kept while a capture is set
+struct SuiteEvents
+{
+    SuiteEvents();
+
+    SuiteResult suite;
+    ContiguousArray<TestResult> tests;
+};
+
+class Reporter
+{
+public:
+    virtual ~Reporter();
+
+    virtual void suiteStarted(const SuiteResult &suite) = 0;
+    virtual void testFinished(const SuiteResult &suite, const TestResult &test) = 0;
+    virtual void suiteFinished(const SuiteResult &suite) = 0;
+    // closes whatever the format still has open, called by the destructor of every writer below if it was not called before
+    virtual void finish();
+
+    // attached reporters get the events of every suite run in this process, the reporter has to outlive the attachment
+    static void attach(Reporter &reporter);
+    static void detach(Reporter &reporter);
+    // also true while this thread captures, suites only collect their results when it is
+    static bool isAttached();
+    // hands the events of one suite to every attached reporter
+    static void publish(const SuiteResult &suite, const TestResult *tests, int count);
+    // while events is set, publish on this thread adds to it instead and replay publishes them later (NULL stops capturing)
+    static void capture(vector<SuiteEvents> *events);
+    static void replay(const vector<SuiteEvents> &events);
+    // for a child right after fork, drops every reporter without taking the lock, which another thread may have held
+    static void detachInChild();
+
+private:
+    static vector<SuiteEvents> *&captured();
+    static vector<Reporter *> &attached();
+    static mutex &lock();
+    static atomic<int> &attachedCount();
+};
+
+// JUnit XML, one testsuite element per suite inside a single testsuites element
+class JUnitReporter : public Reporter
+{
+public:
+    JUnitReporter(ostream &out);
+    ~JUnitReporter();
+
+    void suiteStarted(const SuiteResult &suite);
+    void testFinished(const SuiteResult &suite, const TestResult &test);
+    void suiteFinished(const SuiteResult &suite);
+    void finish();
+
+private:
+    ostream &out;
+    bool finished;
+};
+
+// JSON Lines, one object per event
+class JsonLinesReporter : public Reporter
+{
+public:
+    JsonLinesReporter(ostream &out);
+
+    void suiteStarted(const SuiteResult &suite);
+    void testFinished(const SuiteResult &suite, const TestResult &test);
+    void suiteFinished(const SuiteResult &suite);
+
+private:
+    ostream &out;
+};
+
+// TAP version 13, every test is one numbered line and the plan comes last
+class TapReporter : public Reporter
+{
+public:
+    TapReporter(ostream &out);
+    ~TapReporter();
+
+    void suiteStarted(const SuiteResult &suite);
+    void testFinished(const SuiteResult &suite, const TestResult &test);
+    void suiteFinished(const SuiteResult &suite);
+    void finish();
+
+private:
+    ostream &out;
+    int tests;
+    bool finished;
+};
+
+// ######## helpers ########
+string escapeXml(const string &text);
+string escapeJson(const string &text);
+// newlines would end a TAP line early
+string escapeTap(const string &text);
+string formatSeconds(long long nanoseconds);
+
+#include "reporter.cpp"
+
+#endif
@@ -0,0 +1,638 @@
+#include "scheduler.h"
+
+inline Scheduler::Scheduler() : jobs(0)
+{
+    added = 0;
+    passes = 0;
+    fails = 0;
+    jobTimeout = 0;
+}
+
+inline void Scheduler::add(string name, function<Result(ostream &)> run)
+{
+    jobs.emplace(Job{std::move(name), std::move(run), added++});
+}
+
+template <class T, class J>
+void Scheduler::add(Suite<T, J> &suite)
+{
+    Suite<T, J> *target = &suite;
+    add(suite.getName(), [target](ostream &out)
+    {
+        int passes = target->getPasses();
+        int fails = target->getFails();
+        target->run(out);
+        return Result{target->getPasses() - passes, target->getFails() - fails};
+    });
+}
+
+template <class T, class J>
+void Scheduler::add(Testing<T, J> &testing)
+{
+    for (int i = 0; i < testing.getSuiteCount(); i++)
+    {
+        Suite<T, J> *suite = testing.getSuite(i);
+        if (suite && !suite->hasRun())
+            add(*suite);
+    }
+}
+
+template <class Compare>
+void Scheduler::sort(Compare comp)
+{
+    // jobs that compare equal keep the order they were added in
+    jobs.compact();
+    stable_sort(jobs.begin(), jobs.begin() + jobs.countOccupied(), comp);
+}
+
+inline void Scheduler::sortByName()
+{
+    sort([](const Job &lhs, const Job &rhs)
+    {
+        return lhs.name < rhs.name;
+    });
+}
+
+inline void Scheduler::shard(int index, int count)
+{
+    if (count <= 0 || index < 0 || index >= count)
+        throw out_of_range("Shard " + to_string(index) + " of " + to_string(count) + " does not exist");
+
+    Array<Job> kept(0);
+    int position = 0;
+    for (int i = jobs.nextOccupied(0); i != -1; i = jobs.nextOccupied(i + 1))
+    {
+        if (position++ % count == index)
+            kept.insert(std::move(*jobs[i]));
+    }
+    jobs = std::move(kept);
+}
+
+inline int Scheduler::run(int threads)
+{
+    Array<Job> taken = take();
+    const Array<Job> &batch = taken;
+    int count = batch.countOccupied();
+
+    passes = 0;
+    fails = 0;
+    exception_ptr error;
+    if (threads == 0)
+        threads = Parallel::getThreadCount();
+
+    if (threads <= 1)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            try
+            {
+                Result result = batch[i]->run(cout);
+                passes += result.passes;
+                fails += result.fails;
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = current_exception();
+            }
+        }
+
+        if (error)
+            rethrow_exception(error);
+        return count;
+    }
+
+    ContiguousArray<Result> workers(0);
+    for (int w = 0; w < threads; w++)
+    {
+        workers.insert(Result{0, 0});
+    }
+    ContiguousArray<Outcome> outcomes = waitingOutcomes(count);
+    int printed = 0;
+    mutex printLock;
+    int errorAt = count;
+    bool reporting = Reporter::isAttached();
+
+    Parallel::forEachStolen(count, threads, [&](int i, int worker)
+    {
+        ostringstream out;
+        // reporter events are held back like the output and published in batch order
+        vector<SuiteEvents> captured;
+        if (reporting)
+            Reporter::capture(&captured);
+        try
+        {
+            Result result = batch[i]->run(out);
+            workers[worker]->passes += result.passes;
+            workers[worker]->fails += result.fails;
+        }
+        catch (...)
+        {
+            lock_guard<mutex> guard(printLock);
+            if (i < errorAt)
+            {
+                error = current_exception();
+                errorAt = i;
+            }
+        }
+        Reporter::capture(NULL);
+
+        // whoever finishes the next job in order prints every finished job after it too
+        lock_guard<mutex> guard(printLock);
+        Outcome &outcome = *outcomes[i];
+        outcome.output = out.str();
+        outcome.events = std::move(captured);
+        outcome.done = true;
+        printFinished(outcomes, printed);
+    });
+    cout << flush;
+
+    for (int w = 0; w < threads; w++)
+    {
+        passes += workers[w]->passes;
+        fails += workers[w]->fails;
+    }
+
+    if (error)
+        rethrow_exception(error);
+    return count;
+}
+
+#if SCHEDULER_ISOLATED
+inline int Scheduler::runIsolated(int processes)
+{
+    Array<Job> taken = take();
+    const Array<Job> &batch = taken;
+    int count = batch.countOccupied();
+
+    passes = 0;
+    fails = 0;
+    if (processes == 0)
+        processes = Parallel::getThreadCount();
+    if (processes > count)
+        processes = count;
+    if (processes < 1)
+        return count;
+
+    // a worker that dies makes writes to its pipe fail instead of killing this process
+    struct sigaction ignore, previous;
+    memset(&ignore, 0, sizeof(ignore));
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &ignore, &previous);
+    // anything still buffered would be printed again by every worker
+    cout << flush;
+
+    ContiguousArray<Worker> pool(0);
+    for (int w = 0; w < processes; w++)
+    {
+        pool.insert(Worker{-1, -1, -1, 0, 0, chrono::steady_clock::time_point()});
+    }
+    ContiguousArray<Outcome> outcomes = waitingOutcomes(count);
+    // the workers capture the reporter events of their suites and send them back with the output
+    bool reporting = Reporter::isAttached();
+    // begin and end of every range that was handed to a worker that died before it got to it, taken from the front
+    ContiguousArray<int> retry(0);
+    int retried = 0;
+    int next = 0, finished = 0, printed = 0;
+    chrono::milliseconds limit((long long)(jobTimeout * 1000));
+
+    for (int w = 0; w < processes; w++)
+    {
+        startWorker(pool, w, batch, reporting);
+    }
+
+    // kills the worker if it still runs, so waitpid can not hang on a worker that is stuck or out of step
+    // a worker that already died keeps its own status
+    auto stop = [&](Worker &worker)
+    {
+        int status = 0;
+        close(worker.tasks);
+        close(worker.results);
+        worker.tasks = -1;
+        worker.results = -1;
+        kill(worker.pid, SIGKILL);
+        waitpid(worker.pid, &status, 0);
+        return status;
+    };
+    // the job at the front of a stopped worker fails with note, the rest of its range is handed out again
+    auto replace = [&](int w, const string &note)
+    {
+        Worker &worker = *pool[w];
+        int job = worker.begin;
+        Outcome &outcome = *outcomes[job];
+        outcome.output = string(RED "\nSuite ") + batch[job]->name + " " + note + RESET "\n";
+        if (reporting)
+        {
+            long long elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - worker.started).count();
+            SuiteEvents failed;
+            failed.suite = SuiteResult{batch[job]->name, 0, 1, elapsed};
+            failed.tests.insert(TestResult{"run", false, elapsed, note});
+            outcome.events.push_back(std::move(failed));
+        }
+        outcome.done = true;
+        finished++;
+        fails++;
+
+        if (job + 1 < worker.end)
+        {
+            retry.insert(job + 1);
+            retry.insert(worker.end);
+        }
+        worker.begin = worker.end = 0;
+        startWorker(pool, w, batch, reporting);
+    };
+
+    while (finished < count)
+    {
+        // idle workers get a range of jobs so they do not wait on this process after every suite
+        // the ranges shrink towards the end so the workers finish together, workers with nothing left are told to stop
+        for (int w = 0; w < processes; w++)
+        {
+            Worker &worker = *pool[w];
+            if (worker.begin != worker.end || worker.tasks == -1)
+                continue;
+
+            int range[2];
+            if (retried < retry.getLength())
+            {
+                range[0] = *retry[retried];
+                range[1] = *retry[retried + 1];
+                retried += 2;
+            }
+            else if (next < count)
+            {
+                int size = (count - next) / (processes * 4);
+                range[0] = next;
+                range[1] = next + (size > 1 ? size : 1);
+                next = range[1];
+            }
+            else
+            {
+                close(worker.tasks);
+                worker.tasks = -1;
+                continue;
+            }
+
+            worker.begin = range[0];
+            worker.end = range[1];
+            worker.started = chrono::steady_clock::now();
+            writeAll(worker.tasks, range, sizeof(range));
+        }
+
+        ContiguousArray<pollfd> waiting(0);
+        ContiguousArray<int> owners(0);
+        int timeout = -1;
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        for (int w = 0; w < processes; w++)
+        {
+            const Worker &worker = *pool[w];
+            if (worker.begin != worker.end)
+            {
+                waiting.insert(pollfd{worker.results, POLLIN, 0});
+                owners.insert(w);
+
+                // poll wakes up in time for the earliest deadline
+                if (limit.count() > 0)
+                {
+                    long long left = chrono::duration_cast<chrono::milliseconds>(worker.started + limit - now).count();
+                    left = left > 0 ? left : 0;
+                    if (timeout == -1 || left < timeout)
+                        timeout = (int)left;
+                }
+            }
+        }
+        if (poll(waiting.getLength() ? waiting[0] : NULL, waiting.getLength(), timeout) == -1)
+            continue;
+
+        now = chrono::steady_clock::now();
+        for (int p = 0; p < waiting.getLength(); p++)
+        {
+            int w = *owners[p];
+            Worker &worker = *pool[w];
+            if (!waiting[p]->revents)
+            {
+                if (limit.count() > 0 && now - worker.started >= limit)
+                {
+                    ostringstream note;
+                    note << "timed out after " << jobTimeout << "s";
+                    stop(worker);
+                    replace(w, note.str());
+                }
+                continue;
+            }
+
+            int job = worker.begin;
+            Message message;
+            string text;
+            bool complete = readAll(worker.results, &message, sizeof(message)) && message.job == job && message.length >= 0 && message.eventBytes >= 0;
+            if (complete)
+            {
+                text.resize(message.length + message.eventBytes);
+                complete = readAll(worker.results, &text[0], text.size()) && unpackEvents(text.data() + message.length, message.eventBytes, outcomes[job]->events);
+                text.resize(message.length);
+            }
+
+            if (!complete)
+            {
+                // the worker died part way through its first job, or sent something that does not belong to it
+                int status = stop(worker);
+                string reason = WIFSIGNALED(status) ? "signal " + to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")" : "exit code " + to_string(WEXITSTATUS(status));
+                replace(w, "crashed with " + reason);
+            }
+            else
+            {
+                passes += message.passes;
+                fails += message.fails;
+                worker.begin++;
+                worker.started = now;
+                outcomes[job]->output = text;
+                outcomes[job]->done = true;
+                finished++;
+            }
+        }
+
+        printFinished(outcomes, printed);
+    }
+    cout << flush;
+
+    for (int w = 0; w < processes; w++)
+    {
+        const Worker &worker = *pool[w];
+        if (worker.tasks != -1)
+            close(worker.tasks);
+        close(worker.results);
+        waitpid(worker.pid, NULL, 0);
+    }
+    sigaction(SIGPIPE, &previous, NULL);
+
+    return count;
+}
+
+#endif
+
+inline void Scheduler::setJobTimeout(double seconds)
+{
+    if (seconds < 0)
+        throw invalid_argument("A job timeout can not be negative");
+    jobTimeout = seconds;
+}
+
+inline double Scheduler::getJobTimeout() const
+{
+    return jobTimeout;
+}
+
+inline ContiguousArray<Scheduler::Outcome> Scheduler::waitingOutcomes(int count)
+{
+    ContiguousArray<Outcome> outcomes(0);
+    outcomes.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        outcomes.emplace();
+    }
+    return outcomes;
+}
+
+inline void Scheduler::printFinished(ContiguousArray<Outcome> &outcomes, int &printed)
+{
+    while (printed < outcomes.getLength() && outcomes[printed]->done)
+    {
+        Outcome &outcome = *outcomes[printed];
+        cout << outcome.output;
+        outcome.output.clear();
+        Reporter::replay(outcome.events);
+        outcome.events.clear();
+        printed++;
+    }
+}
+
+inline Array<Scheduler::Job> Scheduler::take()
+{
+    // the batch is taken first so a job can schedule more work for the next run
+    Array<Job> batch(std::move(jobs));
+    jobs = Array<Job>(0);
+    batch.compact();
+    return batch;
+}
+
+#if SCHEDULER_ISOLATED
+inline void Scheduler::startWorker(ContiguousArray<Worker> &pool, int w, const Array<Job> &batch, bool reporting)
+{
+    int tasks[2], results[2];
+    if (pipe(tasks) == -1)
+        throw runtime_error("Could not make a pipe for a worker");
+    if (pipe(results) == -1)
+    {
+        close(tasks[0]);
+        close(tasks[1]);
+        throw runtime_error("Could not make a pipe for a worker");
+    }
+
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        close(tasks[0]);
+        close(tasks[1]);
+        close(results[0]);
+        close(results[1]);
+        throw runtime_error("Could not start a worker process");
+    }
+
+    if (pid == 0)
+    {
+        // the pipes of the other workers are closed so they still see the end of their input
+        for (int other = 0; other < pool.getLength(); other++)
+        {
+            if (pool[other]->tasks != -1)
+                close(pool[other]->tasks);
+            if (pool[other]->results != -1)
+                close(pool[other]->results);
+        }
+        close(tasks[1]);
+        close(results[0]);
+        // the copies of the reporters would write their own documents, the parent gets the captured events instead
+        Reporter::detachInChild();
+        workerLoop(batch, tasks[0], results[1], reporting);
+        _exit(0);
+    }
+
+    close(tasks[0]);
+    close(results[1]);
+    *pool[w] = Worker{pid, tasks[1], results[0], 0, 0, chrono::steady_clock::now()};
+}
+
+inline void Scheduler::workerLoop(const Array<Job> &batch, int tasks, int results, bool reporting)
+{
+    int range[2];
+    while (readAll(tasks, range, sizeof(range)))
+    {
+        for (int job = range[0]; job < range[1]; job++)
+        {
+            if (!runInWorker(batch, job, results, reporting))
+                return;
+        }
+    }
+}
+
+inline bool Scheduler::runInWorker(const Array<Job> &batch, int job, int results, bool reporting)
+{
+    ostringstream out;
+    Result result = {0, 0};
+    vector<SuiteEvents> captured;
+    if (reporting)
+        Reporter::capture(&captured);
+    try
+    {
+        result = batch[job]->run(out);
+    }
+    catch (exception &e)
+    {
+        out << RED << "\nSuite " << batch[job]->name << " threw " << e.what() << RESET << endl;
+        result.fails++;
+    }
+    catch (...)
+    {
+        out << RED << "\nSuite " << batch[job]->name << " threw" << RESET << endl;
+        result.fails++;
+    }
+
+    Reporter::capture(NULL);
+
+    // header, output and events go out in one write
+    string text = out.str();
+    int length = text.size();
+    packEvents(captured, text);
+    Message message = {job, result.passes, result.fails, length, (int)text.size() - length};
+    text.insert(0, reinterpret_cast<const char *>(&message), sizeof(message));
+    return writeAll(results, text.data(), text.size());
+}
+
+inline void Scheduler::packEvents(const vector<SuiteEvents> &events, string &out)
+{
+    // numbers are copied as they are, the worker runs the same binary on the same machine
+    auto number = [&out](long long value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+    auto text = [&](const string &value)
+    {
+        number(value.size());
+        out += value;
+    };
+
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        const SuiteResult &suite = events[e].suite;
+        text(suite.suite);
+        number(suite.passes);
+        number(suite.fails);
+        number(suite.nanoseconds);
+        const ContiguousArray<TestResult> &tests = events[e].tests;
+        number(tests.getLength());
+        for (int t = 0; t < tests.getLength(); t++)
+        {
+            const TestResult &test = *tests[t];
+            text(test.test);
+            number(test.passed);
+            number(test.nanoseconds);
+            text(test.summary);
+        }
+    }
+}
+
+inline bool Scheduler::unpackEvents(const char *data, size_t length, vector<SuiteEvents> &events)
+{
+    const char *end = data + length;
+    auto number = [&](long long &value)
+    {
+        if (size_t(end - data) < sizeof(value))
+            return false;
+        memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+        return true;
+    };
+    auto text = [&](string &value)
+    {
+        long long size;
+        if (!number(size) || size < 0 || size > end - data)
+            return false;
+        value.assign(data, size);
+        data += size;
+        return true;
+    };
+
+    while (data < end)
+    {
+        SuiteEvents suite;
+        long long passes, fails, tests;
+        if (!text(suite.suite.suite) || !number(passes) || !number(fails) || !number(suite.suite.nanoseconds) || !number(tests) || tests < 0)
+            return false;
+        suite.suite.passes = passes;
+        suite.suite.fails = fails;
+        for (long long t = 0; t < tests; t++)
+        {
+            TestResult test;
+            long long passed;
+            if (!text(test.test) || !number(passed) || !number(test.nanoseconds) || !text(test.summary))
+                return false;
+            test.passed = passed != 0;
+            suite.tests.insert(std::move(test));
+        }
+        events.push_back(std::move(suite));
+    }
+    return true;
+}
+
+inline bool Scheduler::readAll(int fd, void *data, size_t length)
+{
+    char *at = static_cast<char *>(data);
+    while (length > 0)
+    {
+        ssize_t got = read(fd, at, length);
+        if (got == -1 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        at += got;
+        length -= got;
+    }
+    return true;
+}
+
+inline bool Scheduler::writeAll(int fd, const void *data, size_t length)
+{
+    const char *at = static_cast<const char *>(data);
+    while (length > 0)
+    {
+        ssize_t put = write(fd, at, length);
+        if (put == -1 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return false;
+        at += put;
+        length -= put;
+    }
+    return true;
+}
+
+#endif
+
+inline int Scheduler::getLength() const
+{
+    return jobs.countOccupied();
+}
+
+inline const Scheduler::Job *Scheduler::getJob(int i) const
+{
+    return jobs[i];
+}
+
+inline int Scheduler::getPasses() const
+{
+    return passes;
+}
+
+inline int Scheduler::getFails() const
+{
+    return fails;
+}
@@ -0,0 +1,143 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstring>
+#include "testing.h"
+#include "arrayAlgorithms.h"
+using namespace std;
+
+// runIsolated forks its workers, so it only exists where fork and pipes do
+#if defined(__unix__) || defined(__APPLE__)
+#define SCHEDULER_ISOLATED 1
+#include <csignal>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define SCHEDULER_ISOLATED 0
+#endif
+
+/*
+Collects suites that were made with RUN_LATER and runs them as one batch
+the batch can be sorted or split into shards before it runs, so the order no longer has to match the order the suites were made in
+suites are held by pointer, they have to outlive the scheduler or at least the next run()
+run(threads) spreads the suites over a work stealing pool, every suite prints into its own buffer and the buffers are written out in batch order
+the tests inside one suite share its counters, so a suite is the smallest piece of work a thread takes
+runIsolated(processes) runs every suite in a forked worker process instead, so a suite that crashes only costs its own result (POSIX only)
+*/
+class Scheduler
+{
+public:
+    struct Result
+    {
+        int passes;
+        int fails;
+    };
+
+    struct Job
+    {
+        string name;
+        function<Result(ostream &)> run; // prints to the stream it is given
+        int order;                       // position the job was added in
+    };
+
+    Scheduler();
+
+    void add(string name, function<Result(ostream &)> run);
+    template <class T, class J>
+    void add(Suite<T, J> &suite);
+    // every suite of the Testing object that has not run yet
+    template <class T, class J>
+    void add(Testing<T, J> &testing);
+
+    template <class Compare>
+    void sort(Compare comp);
+    void sortByName();
+    // keeps every count-th job starting at index, so count schedulers can share one batch
+    void shard(int index, int count);
+
+    // runs the batch and empties it, returns the number of jobs that ran
+    // 1 thread runs it on the calling thread, 0 uses every core (see Parallel)
+    // the first exception a job throws is rethrown once the whole batch is done
+    int run(int threads = 1);
+#if SCHEDULER_ISOLATED
+    // runs the batch in a pool of forked workers that send their results back over pipes, 0 uses one per core
+    // a worker that dies is replaced and its suite counts as one fail, an exception also counts as a fail
+    // a worker that spends longer than the job timeout on one suite is killed, that suite fails as timed out
+    // reporter events come back from the workers and are published in batch order, a crash or timeout is published as a failing suite
+    // the suites in this process are not updated, only the totals below
+    int runIsolated(int processes = 0);
+#endif
+    // seconds one suite may take in runIsolated, 0 waits as long as it takes
+    void setJobTimeout(double seconds);
+    double getJobTimeout() const;
+    int getLength() const;
+    const Job *getJob(int i) const;
+    // totals of the last run, merged from the counters of every worker
+    int getPasses() const;
+    int getFails() const;
+
+private:
+#if SCHEDULER_ISOLATED
+    struct Worker
+    {
+        pid_t pid;
+        int tasks;   // ranges of job indexes go to the worker through this pipe
+        int results; // and one result per job comes back through this one
+        int begin;   // jobs [begin, end) are handed out and not reported yet
+        int end;
+        chrono::steady_clock::time_point started; // of the job at begin
+    };
+
+    // header of every result a worker sends, followed by length bytes of output and eventBytes of packed reporter events
+    struct Message
+    {
+        int job;
+        int passes;
+        int fails;
+        int length;
+        int eventBytes;
+    };
+
+    void startWorker(ContiguousArray<Worker> &pool, int w, const Array<Job> &batch, bool reporting);
+    static void workerLoop(const Array<Job> &batch, int tasks, int results, bool reporting);
+    static bool runInWorker(const Array<Job> &batch, int job, int results, bool reporting);
+    static void packEvents(const vector<SuiteEvents> &events, string &out);
+    static bool unpackEvents(const char *data, size_t length, vector<SuiteEvents> &events);
+    static bool readAll(int fd, void *data, size_t length);
+    static bool writeAll(int fd, const void *data, size_t length);
+#endif
+
+    // what a job left behind until every job before it is printed
+    struct Outcome
+    {
+        string output;
+        vector<SuiteEvents> events;
+        bool done;
+    };
+
+    Array<Job> take();
+    static ContiguousArray<Outcome> waitingOutcomes(int count);
+    // prints the output and publishes the events of the finished jobs that are next in batch order
+    static void printFinished(ContiguousArray<Outcome> &outcomes, int &printed);
+
+    Array<Job> jobs;
+    int added;
+    int passes, fails;
+    double jobTimeout;
+};
+
+#include "scheduler.cpp"
+
+#endif
@@ -0,0 +1,108 @@
+#include "shared.h"
+
+template <class T>
+Shared<T>::Shared(T *owned)
+{
+    block = NULL;
+    if (owned)
+    {
+        block = new Block;
+        block->object = owned;
+        block->refs = 1;
+    }
+}
+
+template <class T>
+Shared<T>::Shared(const Shared<T> &copy)
+{
+    block = copy.block;
+    if (block)
+        block->refs++;
+}
+
+template <class T>
+Shared<T>::Shared(Shared<T> &&other)
+{
+    block = other.block;
+    other.block = NULL;
+}
+
+template <class T>
+Shared<T>::~Shared()
+{
+    release();
+}
+
+template <class T>
+Shared<T> &Shared<T>::operator=(const Shared<T> &rhs)
+{
+    if (block == rhs.block)
+    {
+        return *this;
+    }
+
+    release();
+    block = rhs.block;
+    if (block)
+        block->refs++;
+
+    return *this;
+}
+
+template <class T>
+Shared<T> &Shared<T>::operator=(Shared<T> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    release();
+    block = rhs.block;
+    rhs.block = NULL;
+
+    return *this;
+}
+
+template <class T>
+const T &Shared<T>::read() const
+{
+    return *block->object;
+}
+
+template <class T>
+T *Shared<T>::write()
+{
+    if (!block)
+        return NULL;
+
+    if (block->refs > 1)
+    {
+        // first change to a shared object, so this holder gets its own copy
+        Block *own = new Block;
+        own->object = new T(*block->object);
+        own->refs = 1;
+
+        release();
+        block = own;
+    }
+
+    return block->object;
+}
+
+template <class T>
+int Shared<T>::getUseCount() const
+{
+    return block ? block->refs.load() : 0;
+}
+
+template <class T>
+void Shared<T>::release()
+{
+    if (block && --block->refs == 0)
+    {
+        delete block->object;
+        delete block;
+    }
+    block = NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef SHARED_H
+#define SHARED_H
+
+#include <atomic>
+using namespace std;
+
+/*
+Reference counted holder that shares one object between copies
+read() never copies, write() gives the holder its own copy first if the object is shared (copy on write)
+*/
+template <class T>
+class Shared
+{
+public:
+    // takes ownership of owned
+    explicit Shared(T *owned = NULL);
+    Shared(const Shared<T> &copy);
+    Shared(Shared<T> &&other);
+    ~Shared();
+
+    Shared<T> &operator=(const Shared<T> &rhs);
+    Shared<T> &operator=(Shared<T> &&rhs);
+
+    const T &read() const;
+    T *write();
+    int getUseCount() const;
+
+private:
+    struct Block
+    {
+        T *object;
+        atomic<int> refs;
+    };
+
+    void release();
+
+    Block *block;
+};
+
+#include "shared.cpp"
+
+#endif
@@ -1,232 +1,817 @@
 #include "testing.h"
 
+// ############################ TestPlan code ############################
+inline TestKind parseTestKind(const string &name)
+{
+    for (int kind = 0; kind < TEST_KINDS; kind++)
+    {
+        if (name == TEST_NAMES[kind])
+            return TestKind(kind);
+    }
+    throw invalid_argument("Illegitimate string given: " + name);
+}
+
+inline TestPlan::TestPlan() : kinds(0)
+{
+}
+
+inline TestPlan::TestPlan(initializer_list<TestKind> kinds) : kinds(0)
+{
+    for (TestKind kind : kinds)
+    {
+        add(kind);
+    }
+}
+
+template <class Storage>
+TestPlan::TestPlan(const Array<string, Storage> &names) : kinds(0)
+{
+    for (int i = names.nextOccupied(0); i != -1; i = names.nextOccupied(i + 1))
+    {
+        add(parseTestKind(*names[i]));
+    }
+}
+
+inline void TestPlan::add(TestKind kind)
+{
+    if (kind < 0 || kind >= TEST_KINDS)
+        throw invalid_argument("Unknown test kind");
+    kinds.insert(kind);
+}
+
+inline int TestPlan::getLength() const
+{
+    return kinds.getLength();
+}
+
+inline TestKind TestPlan::operator[](int i) const
+{
+    return *kinds[i];
+}
+
 // ############################ Testing code ############################
 template <class T, class J>
 Testing<T, J>::Testing(T testObject, J correctObject)
 {
-    this->testObject = new T(testObject);
-    this->correctObject = new J(correctObject);
+    this->testObject = Shared<T>(new T(std::move(testObject)));
+    this->correctObject = Shared<J>(new J(std::move(correctObject)));
     testSuites = new Array<Suite<T, J>>(0);
+    benchmarkLimit = 0;
+}
+
+template <class T, class J>
+Testing<T, J>::Testing(Testing<T, J> &&other)
+{
+    testObject = std::move(other.testObject);
+    correctObject = std::move(other.correctObject);
+    testSuites = other.testSuites;
+    benchmarkBody = std::move(other.benchmarkBody);
+    benchmarkLimit = other.benchmarkLimit;
+
+    other.testSuites = NULL;
+}
+
+template <class T, class J>
+Testing<T, J> &Testing<T, J>::operator=(Testing<T, J> &&rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    delete testSuites;
+
+    testObject = std::move(rhs.testObject);
+    correctObject = std::move(rhs.correctObject);
+    testSuites = rhs.testSuites;
+    benchmarkBody = std::move(rhs.benchmarkBody);
+    benchmarkLimit = rhs.benchmarkLimit;
+
+    rhs.testSuites = NULL;
+
+    return *this;
 }
 
 template <class T, class j>
 Testing<T, j>::~Testing()
 {
-    delete testObject;
-    delete correctObject;
     delete testSuites;
 }
 
 template <class T, class J>
 T *Testing<T, J>::getTestObj()
 {
-    return testObject;
+    return testObject.write();
 }
 
 template <class T, class J>
 J *Testing<T, J>::getCorrectObj()
 {
-    return correctObject;
+    return correctObject.write();
 }
 template <class T, class J>
-void Testing<T, J>::createTestSuite(Array<string> testsToRun, string suiteName)
+void Testing<T, J>::createTestSuite(const TestPlan &testsToRun, string suiteName, RunMode mode)
+{
+    // the suite is built in place inside testSuites and shares the objects, it only runs once it has the benchmark
+    Suite<T, J> *suite = testSuites->emplace(testsToRun, testObject, correctObject, std::move(suiteName), RUN_LATER);
+    if (benchmarkBody)
+        suite->setBenchmark(benchmarkBody, benchmarkLimit);
+    if (mode == RUN_NOW)
+        suite->run();
+}
+
+template <class T, class J>
+void Testing<T, J>::setBenchmark(function<void(T &)> body, double limit)
 {
-    Suite<T, J> nSuite(testsToRun, testObject, correctObject, suiteName);
-    testSuites->insertNewItem(nSuite);
+    benchmarkBody = std::move(body);
+    benchmarkLimit = limit;
 }
 template <class T, class J>
 Suite<T, J> *Testing<T, J>::getSuite(int i)
 {
-    return testSuites[i];
+    return (*testSuites)[i];
+}
+template <class T, class J>
+int Testing<T, J>::getSuiteCount() const
+{
+    return testSuites->getLength();
+}
+
+template <class T, class J>
+int Testing<T, J>::getPasses() const
+{
+    int passes = 0;
+    for (int i = 0; i < testSuites->getLength(); i++)
+    {
+        passes += (*testSuites)[i]->getPasses();
+    }
+    return passes;
 }
 
-// ################################ Suite code ############################################
 template <class T, class J>
-Suite<T, J>::Suite(Array<string> &testsToRun, T *testObj, J *correctObj, string suiteName)
+int Testing<T, J>::getFails() const
 {
+    int fails = 0;
+    for (int i = 0; i < testSuites->getLength(); i++)
+    {
+        fails += (*testSuites)[i]->getFails();
+    }
+    return fails;
+}
 
+template <class T, class J>
+Histogram Testing<T, J>::getTestTimes(TestKind kind) const
+{
+    Histogram times;
+    for (int i = 0; i < testSuites->getLength(); i++)
+    {
+        const SmallArray<TestTime> &suiteTimes = (*testSuites)[i]->getTestTimes();
+        for (int t = 0; t < suiteTimes.getLength(); t++)
+        {
+            if (suiteTimes[t]->kind == kind)
+                times.record(suiteTimes[t]->nanoseconds);
+        }
+    }
+    return times;
+}
+
+template <class T, class J>
+Histogram Testing<T, J>::getSuiteTimes() const
+{
+    Histogram times;
+    for (int i = 0; i < testSuites->getLength(); i++)
+    {
+        if ((*testSuites)[i]->hasRun())
+            times.record((*testSuites)[i]->getNanoseconds());
+    }
+    return times;
+}
+
+template <class T, class J>
+void Testing<T, J>::printSummary(ostream &out) const
+{
+    int fails = getFails();
+    out << "\n" << GREEN << getPasses() << " passed" << RESET ", " << (fails ? RED : GREEN) << fails << " failed" << RESET "\n";
+
+    // one row per test kind that ran, then the suites as a whole
+    char row[160];
+    snprintf(row, sizeof(row), "%-8s %8s %10s %10s %10s %10s\n", "", "count", "p50", "p90", "p99", "max");
+    out << row;
+    for (int kind = 0; kind <= TEST_KINDS; kind++)
+    {
+        Histogram times = kind < TEST_KINDS ? getTestTimes(TestKind(kind)) : getSuiteTimes();
+        if (times.getCount() == 0)
+            continue;
+        snprintf(row, sizeof(row), "%-8s %8lld %10s %10s %10s %10s\n", kind < TEST_KINDS ? TEST_NAMES[kind] : "suites", times.getCount(),
+                 formatNanoseconds(times.percentile(50)).c_str(), formatNanoseconds(times.percentile(90)).c_str(),
+                 formatNanoseconds(times.percentile(99)).c_str(), formatNanoseconds(times.getMax()).c_str());
+        out << row;
+    }
+    out << flush;
+}
+
+// ################################ Suite code ############################################
+template <class T, class J>
+Suite<T, J>::Suite(const TestPlan &testsToRun, T *testObj, J *correctObj, string suiteName, RunMode mode) : plan(testsToRun), times(0)
+{
+    nanoseconds = 0;
+    benchmarkLimit = 0;
+    benchmarkStats = BenchmarkStats();
     this->passes = 0;
     this->fails = 0;
-    this->testObj = new T(*testObj);
-    this->correctObj = new J(*correctObj);
-    this->suiteName = suiteName;
-    runTests(testsToRun);
+    this->testObj = Shared<T>(new T(*testObj));
+    this->correctObj = Shared<J>(new J(*correctObj));
+    this->suiteName = std::move(suiteName);
+    ran = false;
+    if (mode == RUN_NOW)
+        run();
 }
 template <class T, class J>
-Suite<T, J>::Suite(Array<string> &testsToRun, T testObj, J correctObj, string suiteName)
+Suite<T, J>::Suite(const TestPlan &testsToRun, T testObj, J correctObj, string suiteName, RunMode mode) : plan(testsToRun), times(0)
 {
-
+    nanoseconds = 0;
+    benchmarkLimit = 0;
+    benchmarkStats = BenchmarkStats();
     this->passes = 0;
     this->fails = 0;
-    this->testObj = new T(testObj);
-    this->correctObj = new J(correctObj);
-    this->suiteName = suiteName;
-
-    runTests(testsToRun);
+    this->testObj = Shared<T>(new T(std::move(testObj)));
+    this->correctObj = Shared<J>(new J(std::move(correctObj)));
+    this->suiteName = std::move(suiteName);
+    ran = false;
+    if (mode == RUN_NOW)
+        run();
+}
+template <class T, class J>
+Suite<T, J>::Suite(const TestPlan &testsToRun, const Shared<T> &testObj, const Shared<J> &correctObj, string suiteName, RunMode mode) : plan(testsToRun), times(0)
+{
+    nanoseconds = 0;
+    benchmarkLimit = 0;
+    benchmarkStats = BenchmarkStats();
+    this->passes = 0;
+    this->fails = 0;
+    this->testObj = testObj;
+    this->correctObj = correctObj;
+    this->suiteName = std::move(suiteName);
+    ran = false;
+    if (mode == RUN_NOW)
+        run();
 }
 template <class T, class J>
-Suite<T, J>::Suite(Suite<T, J> &copy)
+Suite<T, J>::Suite(const Suite<T, J> &copy) : plan(copy.plan), times(copy.times)
 {
+    nanoseconds = copy.nanoseconds;
+    benchmarkBody = copy.benchmarkBody;
+    benchmarkLimit = copy.benchmarkLimit;
+    benchmarkStats = copy.benchmarkStats;
     passes = copy.passes;
     fails = copy.fails;
-    testObj = new T(*copy.testObj);
-    correctObj = new J(*copy.correctObj);
+    suiteName = copy.suiteName;
+    ran = copy.ran;
+    testObj = copy.testObj;
+    correctObj = copy.correctObj;
+}
+template <class T, class J>
+Suite<T, J>::Suite(Suite<T, J> &&other) : plan(std::move(other.plan)), times(std::move(other.times))
+{
+    nanoseconds = other.nanoseconds;
+    benchmarkBody = std::move(other.benchmarkBody);
+    benchmarkLimit = other.benchmarkLimit;
+    benchmarkStats = other.benchmarkStats;
+    passes = other.passes;
+    fails = other.fails;
+    suiteName = std::move(other.suiteName);
+    ran = other.ran;
+    testObj = std::move(other.testObj);
+    correctObj = std::move(other.correctObj);
 }
 
 template <class T, class J>
-void Suite<T, J>::runTests(Array<string>& testsToRun)
+void Suite<T, J>::run()
 {
-    cout << +RED "\nStarting test suite " << suiteName + RESET << endl;
-    for (int i = 0; i < testsToRun.getLength(); i++)
+    run(cout);
+}
+
+template <class T, class J>
+void Suite<T, J>::run(ostream &out)
+{
+    ran = true;
+    // a suite can run again, so only the fails of this run decide what is dropped
+    int failsBefore = fails;
+    report.open(out);
+    size_t start = report.mark();
+    try
+    {
+        runTests(plan);
+    }
+    catch (...)
     {
+        report.close();
+        throw;
+    }
+    // a run without failures says nothing at all under REPORT_FAILURES
+    if (fails == failsBefore && Report::getDetail() == REPORT_FAILURES)
+        report.drop(start);
+    report.close();
+}
+
+template <class T, class J>
+bool Suite<T, J>::hasRun() const
+{
+    return ran;
+}
+
+template <class T, class J>
+string Suite<T, J>::getName() const
+{
+    return suiteName;
+}
+
+template <class T, class J>
+int Suite<T, J>::getPasses() const
+{
+    return passes;
+}
+
+template <class T, class J>
+int Suite<T, J>::getFails() const
+{
+    return fails;
+}
+
+template <class T, class J>
+const SmallArray<TestTime> &Suite<T, J>::getTestTimes() const
+{
+    return times;
+}
 
-        if (*testsToRun[i] == "==")
-            equalsTest();
-        else if (*testsToRun[i] == "TC")
+template <class T, class J>
+long long Suite<T, J>::getNanoseconds() const
+{
+    return nanoseconds;
+}
+
+template <class T, class J>
+void Suite<T, J>::runTests(const TestPlan &testsToRun)
+{
+    report << RED "\nStarting test suite " << suiteName + RESET "\n";
+    bool reporting = Reporter::isAttached();
+    SmallArray<TestResult> results(0);
+    times.deleteAll();
+    int passed = passes, failed = fails;
+    chrono::steady_clock::time_point suiteStart = chrono::steady_clock::now();
+    for (int i = 0; i < testsToRun.getLength(); i++)
+    {
+        size_t mark = report.mark();
+        int failedBefore = fails;
+        summary.clear();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        try
         {
-            textCompare();
+            (this->*TESTS[testsToRun[i]])();
         }
-        else
+        catch (...)
+        {
+            // the exception still leaves the suite, but reporters see the suite fail on this test first
+            if (reporting)
+            {
+                string reason = "threw";
+                try
+                {
+                    throw;
+                }
+                catch (exception &e)
+                {
+                    reason += string(" ") + e.what();
+                }
+                catch (...)
+                {
+                }
+                chrono::steady_clock::time_point now = chrono::steady_clock::now();
+                TestResult result = {TEST_NAMES[testsToRun[i]], false, chrono::duration_cast<chrono::nanoseconds>(now - start).count(), reason};
+                results.insert(result);
+                SuiteResult suite = {suiteName, passes - passed, fails - failed + 1, chrono::duration_cast<chrono::nanoseconds>(now - suiteStart).count()};
+                Reporter::publish(suite, results[0], results.getLength());
+            }
+            throw;
+        }
+        TestTime time = {testsToRun[i], chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()};
+        times.insert(time);
+
+        if (reporting)
         {
-            cout << "Illegitimate string given" << endl;
+            TestResult result = {TEST_NAMES[testsToRun[i]], fails == failedBefore, time.nanoseconds, summary};
+            results.insert(result);
         }
+        if (fails == failedBefore && Report::getDetail() == REPORT_FAILURES)
+            report.drop(mark);
+        report.flush();
+    }
+
+    nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - suiteStart).count();
+    if (reporting)
+    {
+        SuiteResult suite = {suiteName, passes - passed, fails - failed, nanoseconds};
+        Reporter::publish(suite, results.getLength() ? results[0] : NULL, results.getLength());
     }
 }
 
+template <class T, class J>
+void (Suite<T, J>::*const Suite<T, J>::TESTS[TEST_KINDS])() = {&Suite<T, J>::equalsTest, &Suite<T, J>::textCompare, &Suite<T, J>::lineCompare, &Suite<T, J>::benchmarkTest};
+
 template <class T, class J>
 Suite<T, J>::~Suite()
 {
-    delete testObj;
-    delete correctObj;
 }
 // prints the states upon deletion
 // requires that T and J have to_String() overloaded
 template <class T, class J>
 void Suite<T, J>::textCompare()
 {
-    textCompare(*testObj, *correctObj);
+    textCompare(testObj.read(), correctObj.read());
 }
 
 template <class T, class J>
 template <class X, class Y>
 void Suite<T, J>::textCompare(X &lhs, Y &rhs)
 {
-    cout << "\nRunning text compare" << endl;
+    report << "\nRunning text compare\n";
     string tstString = to_string(lhs);
     string corString = to_string(rhs);
-    string output = "";
+    string output;
     bool testPassed = true;
     int index = 0;
 
-    while (index < tstString.length() && index < corString.length())
+    // equal strings are the common case and need no diff
+    if (tstString.length() == corString.length() && findMismatch(tstString.data(), corString.data(), tstString.length()) == tstString.length())
     {
-        if (tstString[index] == corString[index])
-            output += printGreen(index, tstString, corString);
+        output.reserve(tstString.length() + 16);
+        output += GREEN;
+        output += tstString;
+        output += RESET;
+    }
+    else
+    {
+        fails++;
+        testPassed = false;
+
+        ContiguousArray<Edit> script(0);
+        if (diffText(tstString, corString, script))
+        {
+            output = printDiff(tstString, corString, script);
+            summary = summarizeDiff(script, "chars");
+        }
         else
         {
-            output += printRed(index, tstString, corString);
-
-            if (testPassed)
+            // too different to diff within the work limit, so the strings are compared by position
+            report << "Too many differences for a diff, comparing by position\n";
+            summary = "Too many differences for a diff, the output has " + to_string(tstString.length()) + " chars and should have " + to_string(corString.length());
+            while (index < int(tstString.length()) && index < int(corString.length()))
             {
-                fails++;
-                testPassed = false;
+                if (tstString[index] == corString[index])
+                    output += printGreen(index, tstString, corString);
+                else
+                    output += printRed(index, tstString, corString);
             }
+
+            if (index < int(tstString.length()))
+                output += RED + tstString.substr(index) + RESET;
+            if (index < int(corString.length()))
+                output += YELLOW + corString.substr(index) + RESET;
         }
     }
 
-    if (tstString.length() != output.length())
+    if (testPassed)
+        passes++;
+
+    report << "The output was " << output << "\nThe output should be " << GREEN << corString << RESET "\n";
+    report << "Text compare finished\n\n";
+}
+
+template <class T, class J>
+void Suite<T, J>::lineCompare()
+{
+    lineCompare(testObj.read(), correctObj.read());
+}
+
+template <class T, class J>
+template <class X, class Y>
+void Suite<T, J>::lineCompare(X &lhs, Y &rhs)
+{
+    report << "\nRunning line compare\n";
+    string tstString = to_string(lhs);
+    string corString = to_string(rhs);
+
+    if (tstString.length() == corString.length() && findMismatch(tstString.data(), corString.data(), tstString.length()) == tstString.length())
     {
-        output += YELLOW + tstString.substr(index, tstString.length() - index) + RESET;
+        passes++;
+        report << GREEN << "All " << splitLines(tstString).count() << " lines match" << RESET "\n";
     }
+    else
+    {
+        fails++;
 
-    if (testPassed)
-        passes++;
+        Lines tstLines = splitLines(tstString);
+        Lines corLines = splitLines(corString);
+        ContiguousArray<Edit> script(0);
+        if (!diffLines(tstString, tstLines, corString, corLines, script))
+            report << "Some changed blocks were too different to diff, their lines are shown as removed and missing\n";
+
+        report << printLineDiff(tstString, tstLines, corString, corLines, script);
+        summary = summarizeDiff(script, "lines");
+        // splitLines reads a missing last newline as if it was there, so it never shows up in the script
+        bool tstNewline = !tstString.empty() && tstString.back() == '\n';
+        bool corNewline = !corString.empty() && corString.back() == '\n';
+        if (!tstString.empty() && !corString.empty() && tstNewline != corNewline)
+        {
+            string newline = tstNewline ? "The output ends with a newline that it should not have" : "The output is missing the newline at its end";
+            report << (tstNewline ? RED : YELLOW) << newline << RESET "\n";
+            bool onlyNewline = script.getLength() == 1 && script[0]->kind == EDIT_EQUAL;
+            summary = onlyNewline ? newline : summary + ", " + newline;
+        }
+    }
 
-    cout << "The output was " << output << "\nThe output should be " << GREEN << corString << RESET << endl;
-    cout << "Text compare finished\n"
-         << endl;
+    report << "Line compare finished\n\n";
 }
 
 template <class T, class J>
 void Suite<T, J>::equalsTest()
 {
-    equalsTest(*testObj, *correctObj);
+    equalsFixtures(integral_constant<bool, HasConstEquals<T, J>::value>());
+}
+
+template <class T, class J>
+void Suite<T, J>::equalsFixtures(true_type)
+{
+    equalsTest(testObj.read(), correctObj.read());
+}
+
+template <class T, class J>
+void Suite<T, J>::equalsFixtures(false_type)
+{
+    equalsTest(*testObj.write(), *correctObj.write());
 }
 template <class T, class J>
 template <class X, class Y>
 void Suite<T, J>::equalsTest(X &lhs, Y &rhs) // makes use of a copy constuctor
 {
-    cout << "\nStarting equals test" << endl;
+    report << "\nStarting equals test\n";
     if (lhs == rhs)
     {
         passes++;
-        cout << GREEN << "Items are equal" << RESET << endl;
+        report << GREEN << "Items are equal" << RESET "\n";
     }
     else
     {
         fails++;
-        cout << RED << "Items are not equal" << RESET << endl;
+        summary = "Items are not equal";
+        report << RED << summary << RESET "\n";
+    }
+
+    report << "ending equals test\n\n";
+}
+template <class T, class J>
+void Suite<T, J>::setBenchmark(function<void(T &)> body, double limit)
+{
+    benchmarkBody = std::move(body);
+    benchmarkLimit = limit;
+}
+
+template <class T, class J>
+void Suite<T, J>::benchmarkTest()
+{
+    report << "\nRunning benchmark\n";
+    if (!benchmarkBody)
+    {
+        fails++;
+        summary = "No benchmark was set";
+        report << RED << summary << RESET "\n";
+        report << "Benchmark finished\n\n";
+        return;
+    }
+
+    // the body gets the suite's own copy so a shared test object is copied once, not on every call
+    T &object = *testObj.write();
+    function<void(T &)> &body = benchmarkBody;
+    benchmarkStats = Microbenchmark::measure([&]()
+                                             { body(object); });
+
+    report << benchmarkStats.iterations << " calls in each of " << benchmarkStats.samples << " samples, " << benchmarkStats.rejected << " outliers dropped\n";
+    report << "mean " << formatNanoseconds(benchmarkStats.mean) << ", median " << formatNanoseconds(benchmarkStats.median)
+           << ", stddev " << formatNanoseconds(benchmarkStats.stddev) << " per call\n";
+
+    if (benchmarkLimit > 0 && benchmarkStats.median > benchmarkLimit)
+    {
+        fails++;
+        summary = "Median " + formatNanoseconds(benchmarkStats.median) + " is over the limit of " + formatNanoseconds(benchmarkLimit);
+        report << RED << summary << RESET "\n";
+    }
+    else
+    {
+        passes++;
+        if (benchmarkLimit > 0)
+            report << GREEN << "Within the limit of " << formatNanoseconds(benchmarkLimit) << RESET "\n";
     }
+    report << "Benchmark finished\n\n";
+}
 
-    cout << "ending equals test\n"
-         << endl;
+template <class T, class J>
+const BenchmarkStats &Suite<T, J>::getBenchmarkStats() const
+{
+    return benchmarkStats;
 }
+
 template <class T, class J>
-Suite<T, J> &Suite<T, J>::operator=(Suite<T, J> &copy)
+Suite<T, J> &Suite<T, J>::operator=(const Suite<T, J> &copy)
 {
 
     if (this == &copy)
     {
         return *this;
     }
-    delete testObj;
-    delete correctObj;
-
-    testObj = new T(*copy.testObj);
-    correctObj = new J(*copy.correctObj);
+    testObj = copy.testObj;
+    correctObj = copy.correctObj;
 
     passes = copy.passes;
     fails = copy.fails;
     suiteName = copy.suiteName;
+    plan = copy.plan;
+    ran = copy.ran;
+    times = copy.times;
+    nanoseconds = copy.nanoseconds;
+    benchmarkBody = copy.benchmarkBody;
+    benchmarkLimit = copy.benchmarkLimit;
+    benchmarkStats = copy.benchmarkStats;
 
     return *this;
 }
 
 template <class T, class J>
-string Suite<T, J>::printGreen(int &index, string tstString, string corString)
+Suite<T, J> &Suite<T, J>::operator=(Suite<T, J> &&other)
 {
-    string output = GREEN;
-    while (index < tstString.length() && index < corString.length() && tstString[index] == corString[index])
+    if (this == &other)
     {
-        output += tstString[index++];
+        return *this;
     }
+    testObj = std::move(other.testObj);
+    correctObj = std::move(other.correctObj);
+
+    passes = other.passes;
+    fails = other.fails;
+    suiteName = std::move(other.suiteName);
+    plan = std::move(other.plan);
+    ran = other.ran;
+    times = std::move(other.times);
+    nanoseconds = other.nanoseconds;
+    benchmarkBody = std::move(other.benchmarkBody);
+    benchmarkLimit = other.benchmarkLimit;
+    benchmarkStats = other.benchmarkStats;
+
+    return *this;
+}
+
+template <class T, class J>
+string Suite<T, J>::printGreen(int &index, const string &tstString, const string &corString)
+{
+    // the run of equal chars starting at index
+    size_t shared = min(tstString.length(), corString.length()) - index;
+    size_t run = findMismatch(tstString.data() + index, corString.data() + index, shared);
+
+    string output = GREEN + tstString.substr(index, run) + RESET;
+    index += run;
+    return output;
+}
+template <class T, class J>
+string Suite<T, J>::printRed(int &index, const string &tstString, const string &corString)
+{
+    // the run of unequal chars starting at index
+    size_t shared = min(tstString.length(), corString.length()) - index;
+    size_t run = findMatch(tstString.data() + index, corString.data() + index, shared);
 
-    output += RESET;
+    string output = RED + tstString.substr(index, run) + RESET;
+    index += run;
+    return output;
+}
+template <class T, class J>
+string Suite<T, J>::printDiff(const string &tstString, const string &corString, const ContiguousArray<Edit> &script)
+{
+    // matching chars are green, chars the test string should not have are red and chars it is missing are yellow
+    string output;
+    output.reserve(tstString.length() + 16 * script.getLength());
+    for (int i = 0; i < script.getLength(); i++)
+    {
+        const Edit &edit = *script[i];
+        if (edit.kind == EDIT_EQUAL)
+            output += GREEN + tstString.substr(edit.testBegin, edit.length) + RESET;
+        else if (edit.kind == EDIT_DELETE)
+            output += RED + tstString.substr(edit.testBegin, edit.length) + RESET;
+        else
+            output += YELLOW + corString.substr(edit.correctBegin, edit.length) + RESET;
+    }
     return output;
 }
 template <class T, class J>
-string Suite<T, J>::printRed(int &index, string tstString, string corString)
+string Suite<T, J>::summarizeDiff(const ContiguousArray<Edit> &script, const string &unit)
 {
-    string output = RED;
-    while (index < tstString.length() && index < corString.length() && tstString[index] != corString[index])
+    int removed = 0, missing = 0;
+    for (int i = 0; i < script.getLength(); i++)
     {
-        output += tstString[index++];
+        if (script[i]->kind == EDIT_DELETE)
+            removed += script[i]->length;
+        else if (script[i]->kind == EDIT_INSERT)
+            missing += script[i]->length;
     }
+    return to_string(removed) + " " + unit + " should not be there and " + to_string(missing) + " are missing";
+}
+
+template <class T, class J>
+string Suite<T, J>::printLineDiff(const string &tstString, const Lines &tstLines, const string &corString, const Lines &corLines, const ContiguousArray<Edit> &script)
+{
+    // "  " equal, "- " only in the test output, "+ " missing from it, "~ " changed with the chars marked like printDiff
+    string output;
+    for (int e = 0; e < script.getLength(); e++)
+    {
+        const Edit &edit = *script[e];
+        if (edit.kind == EDIT_EQUAL)
+        {
+            // long runs keep a few lines of context next to the changes around them
+            int head = e == 0 ? 0 : LINE_CONTEXT;
+            int tail = e == script.getLength() - 1 ? 0 : LINE_CONTEXT;
+            for (int i = 0; i < edit.length; i++)
+            {
+                if (i == head && edit.length > head + tail + 1)
+                {
+                    output += "  ... " + to_string(edit.length - head - tail) + " equal lines ...\n";
+                    i = edit.length - tail - 1;
+                    continue;
+                }
+                int line = edit.testBegin + i;
+                output += GREEN "  " + tstString.substr(tstLines.begin(line), tstLines.length(line)) + RESET "\n";
+            }
+            continue;
+        }
+
+        // a block of removed lines next to a block of missing lines is paired up line by line
+        const Edit *removed = edit.kind == EDIT_DELETE ? &edit : NULL;
+        const Edit *missing = edit.kind == EDIT_INSERT ? &edit : NULL;
+        if (e + 1 < script.getLength() && script[e + 1]->kind != EDIT_EQUAL)
+        {
+            e++;
+            if (removed)
+                missing = script[e];
+            else
+                removed = script[e];
+        }
 
-    output += RESET;
+        int removedCount = removed ? removed->length : 0;
+        int missingCount = missing ? missing->length : 0;
+        for (int i = 0; i < removedCount || i < missingCount; i++)
+        {
+            if (i < removedCount && i < missingCount)
+            {
+                string tstLine = tstString.substr(tstLines.begin(removed->testBegin + i), tstLines.length(removed->testBegin + i));
+                string corLine = corString.substr(corLines.begin(missing->correctBegin + i), corLines.length(missing->correctBegin + i));
+                ContiguousArray<Edit> chars(0);
+                // only lines that keep at least half their chars are shown as changed, others as removed and missing
+                int same = 0;
+                bool diffed = diffText(tstLine, corLine, chars, LINE_PAIR_WORK);
+                for (int c = 0; diffed && c < chars.getLength(); c++)
+                {
+                    if (chars[c]->kind == EDIT_EQUAL)
+                        same += chars[c]->length;
+                }
+                if (diffed && 2 * same >= (int)max(tstLine.length(), corLine.length()))
+                {
+                    output += "~ " + printDiff(tstLine, corLine, chars) + "\n";
+                    continue;
+                }
+            }
+            if (i < removedCount)
+                output += RED "- " + tstString.substr(tstLines.begin(removed->testBegin + i), tstLines.length(removed->testBegin + i)) + RESET "\n";
+            if (i < missingCount)
+                output += YELLOW "+ " + corString.substr(corLines.begin(missing->correctBegin + i), corLines.length(missing->correctBegin + i)) + RESET "\n";
+        }
+    }
     return output;
 }
 template <class T, class J>
+T *Suite<T, J>::getTestObj()
+{
+    // the caller may change the object, so it stops being shared
+    return testObj.write();
+}
+template <class T, class J>
+J *Suite<T, J>::getCorrectObj()
+{
+    return correctObj.write();
+}
+template <class T, class J>
 void Suite<T, J>::setTest(T *testObj)
 {
-
-    delete testObj;
-    testObj = new T(*testObj);
+    this->testObj = Shared<T>(new T(*testObj));
     // makes a copy
 }
 template <class T, class J>
 void Suite<T, J>::setCorrect(J *corrObj)
 {
-    delete correctObj;
-    correctObj = new J(*correctObj);
+    correctObj = Shared<J>(new J(*corrObj));
 }
@@ -1,8 +1,21 @@
 #ifndef Testing_H
 #define Testing_H
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include "array.h"
+#include "histogram.h"
+#include "microbenchmark.h"
+#include "shared.h"
+#include "lineDiff.h"
+#include "report.h"
+#include "reporter.h"
 using namespace std;
 
 #define RED "\033[31m"
@@ -12,14 +25,80 @@ using namespace std;
 
 /*
 All classes put into T and J must have overloads of
-==
+== (best callable on const objects, see below)
 copy constructor
 string to_string(T obj)
+
+Suites share the test and correct objects with the Testing object and each other,
+an object is only copied when it gets changed through a getter or setter
+an == that only takes non-const objects still works, but then the equals test gives the suite its own copies to compare
 */
 
 template <class T, class J>
 class Suite;
 
+// true when const X == const Y compiles
+template <class X, class Y>
+class HasConstEquals
+{
+    template <class A, class B>
+    static auto check(int) -> decltype(declval<const A &>() == declval<const B &>(), true_type());
+    template <class A, class B>
+    static false_type check(...);
+
+public:
+    static const bool value = decltype(check<X, Y>(0))::value;
+};
+
+// names of the tests to run, short enough to never allocate
+typedef SmallArray<string> TestNames;
+
+// every kind of test a suite can run, the order matches Suite::TESTS and TEST_NAMES
+enum TestKind
+{
+    EQUALS,
+    TEXT_COMPARE,
+    LINE_COMPARE,
+    BENCHMARK,
+    TEST_KINDS // number of kinds
+};
+
+const char *const TEST_NAMES[TEST_KINDS] = {"==", "TC", "LC", "BM"};
+
+// throws invalid_argument for a name that is not a test
+TestKind parseTestKind(const string &name);
+
+// how long one test of the last run of a suite took
+struct TestTime
+{
+    TestKind kind;
+    long long nanoseconds;
+};
+
+// RUN_NOW runs a suite as soon as it is made, RUN_LATER only registers it so a Scheduler can run it (see scheduler.h)
+enum RunMode
+{
+    RUN_NOW,
+    RUN_LATER
+};
+
+// the tests a suite runs, names are parsed once when the plan is made so a typo fails before any suite runs
+class TestPlan
+{
+public:
+    TestPlan();
+    TestPlan(initializer_list<TestKind> kinds);
+    template <class Storage>
+    TestPlan(const Array<string, Storage> &names);
+
+    void add(TestKind kind);
+    int getLength() const;
+    TestKind operator[](int i) const;
+
+private:
+    SmallArray<TestKind> kinds;
+};
+
 string to_string(string obj)
 {
     return obj;
@@ -29,22 +108,42 @@ template <class T, class J>
 class Testing
 {
 private:
-    T *testObject; // used for the start of all tests as a base
-    // make a new test object copy
-    J *correctObject; // used for the start of all tests as a base
-    // make a new test object copy
+    Shared<T> testObject; // used for the start of all tests as a base
+    // suites share it until one of them changes it
+    Shared<J> correctObject; // used for the start of all tests as a base
+    // suites share it until one of them changes it
 
     Array<Suite<T, J>> *testSuites;
+    function<void(T &)> benchmarkBody; // given to every suite made after setBenchmark
+    double benchmarkLimit;
     // T must have the == operator overloaded with itself to check validity.
     // there will also be single value checks made as static functions for specific unit checks
 
 public:
     Testing(T testObject, J correctObject);
+    Testing(Testing<T, J> &&other);
     ~Testing();
+
+    // suites and objects are owned, so a Testing object can only be moved
+    Testing(const Testing<T, J> &) = delete;
+    Testing<T, J> &operator=(const Testing<T, J> &) = delete;
+    Testing<T, J> &operator=(Testing<T, J> &&rhs);
+
     T *getTestObj();
     J *getCorrectObj();
     Suite<T, J> *getSuite(int i);
-    void createTestSuite(Array<string> testsToRun, string suiteName = "Test");
+    int getSuiteCount() const;
+    void createTestSuite(const TestPlan &testsToRun, string suiteName = "Test", RunMode mode = RUN_NOW);
+    // the benchmark of every suite created from now on, see Suite::setBenchmark
+    void setBenchmark(function<void(T &)> body, double limit = 0);
+
+    int getPasses() const;
+    int getFails() const;
+    // the times of the last run of every suite that ran
+    Histogram getTestTimes(TestKind kind) const;
+    Histogram getSuiteTimes() const;
+    // passes and fails with p50, p90, p99 and max of every test kind that ran and of the suites
+    void printSummary(ostream &out = cout) const;
 };
 
 template <class T, class J>
@@ -53,31 +152,72 @@ class Suite
 private:
     int passes, fails;
     string suiteName;
+    TestPlan plan; // run by run()
+    bool ran;
+    Report report; // where the tests print, buffered while run() is running
+    string summary; // one line on why the running test failed, for the attached reporters (see reporter.h)
+    SmallArray<TestTime> times; // every test of the last run in the order it ran
+    long long nanoseconds;      // the whole last run
+
+    function<void(T &)> benchmarkBody;
+    double benchmarkLimit;
+    BenchmarkStats benchmarkStats; // of the last benchmark test
 
-    T *testObj;
-    J *correctObj;
-    // copy of the pointers made initially
+    Shared<T> testObj;
+    Shared<J> correctObj;
+    // shared with the objects the suite was made from, copied on the first change
 
 public:
-    Suite(Array<string> &testsToRun, T *testObj, J *correctObj, string suiteName = "Test");
-    Suite(Array<string> &testsToRun, T testObj, J correctObj, string suiteName = "Test");
-    Suite(Suite<T, J> &copy);
+    Suite(const TestPlan &testsToRun, T *testObj, J *correctObj, string suiteName = "Test", RunMode mode = RUN_NOW);
+    Suite(const TestPlan &testsToRun, T testObj, J correctObj, string suiteName = "Test", RunMode mode = RUN_NOW);
+    Suite(const TestPlan &testsToRun, const Shared<T> &testObj, const Shared<J> &correctObj, string suiteName = "Test", RunMode mode = RUN_NOW);
+    Suite(const Suite<T, J> &copy);
+    Suite(Suite<T, J> &&other);
     ~Suite();
     // prints the states upon deletion
-    void runTests(Array<string>& testsToRun);
+    // runs the plan the suite was made with, the output is written to out in one go once the suite is done
+    void run();
+    void run(ostream &out);
+    bool hasRun() const;
+    string getName() const;
+    int getPasses() const;
+    int getFails() const;
+    const SmallArray<TestTime> &getTestTimes() const;
+    long long getNanoseconds() const;
+    // runs the tests and hands their results to the attached reporters
+    void runTests(const TestPlan &testsToRun);
+    // one entry per TestKind
+    static void (Suite<T, J>::*const TESTS[TEST_KINDS])();
     void textCompare();
     template <class X, class Y>
     void textCompare(X &lhs, Y &rhs);
+    // like textCompare but diffs line by line, for large multi line output
+    void lineCompare();
+    template <class X, class Y>
+    void lineCompare(X &lhs, Y &rhs);
     void equalsTest();
     template <class X, class Y>
     void equalsTest(X &lhs, Y &rhs);
+    // the fixtures are compared as const when their == allows it, otherwise through the suite's own copies
+    void equalsFixtures(true_type);
+    void equalsFixtures(false_type);
+    // times body on the suite's own copy of the test object (see microbenchmark.h)
+    // with a limit the test fails when the median call takes longer than limit nanoseconds
+    void setBenchmark(function<void(T &)> body, double limit = 0);
+    void benchmarkTest();
+    const BenchmarkStats &getBenchmarkStats() const;
     T *getTestObj();
     J *getCorrectObj();
     void setTest(T *testObj);
     void setCorrect(J *corrObj);
-    Suite<T, J> &operator=(Suite<T, J> &copy);
-    static string printGreen(int &index, string tstString, string corString);
-    static string printRed(int &index, string tstString, string corString);
+    Suite<T, J> &operator=(const Suite<T, J> &copy);
+    Suite<T, J> &operator=(Suite<T, J> &&other);
+    static string printGreen(int &index, const string &tstString, const string &corString);
+    static string printRed(int &index, const string &tstString, const string &corString);
+    static string printDiff(const string &tstString, const string &corString, const ContiguousArray<Edit> &script);
+    // how many units an edit script removes and adds
+    static string summarizeDiff(const ContiguousArray<Edit> &script, const string &unit);
+    static string printLineDiff(const string &tstString, const Lines &tstLines, const string &corString, const Lines &corLines, const ContiguousArray<Edit> &script);
 };
 
 #include "testing.cpp"
@@ -0,0 +1,191 @@
+#include "textDiff.h"
+
+inline bool diffText(const string &test, const string &correct, ContiguousArray<Edit> &script, long long maxWork)
+{
+    return diffSequence(test.data(), test.length(), correct.data(), correct.length(), script, maxWork);
+}
+
+template <class Item>
+bool diffSequence(const Item *test, int testLength, const Item *correct, int correctLength, ContiguousArray<Edit> &script, long long maxWork)
+{
+    // every step of the search costs at least one unit of work, so the number of edits searched is at most sqrt(maxWork)
+    long long limit = 1;
+    while (limit * limit < maxWork)
+    {
+        limit++;
+    }
+    long long longest = ((long long)testLength + correctLength + 1) / 2;
+    if (limit > longest)
+        limit = longest;
+
+    DiffState<Item> state;
+    state.test = test;
+    state.correct = correct;
+    state.offset = limit + 1;
+    state.forward.assign(2 * limit + 3, 0);
+    state.backward.assign(2 * limit + 3, 0);
+    state.work = 0;
+    state.maxWork = maxWork;
+    state.script = &script;
+
+    return diffRange(state, 0, testLength, 0, correctLength);
+}
+
+inline void addEdit(ContiguousArray<Edit> &script, EditKind kind, int testBegin, int correctBegin, int length)
+{
+    if (length <= 0)
+        return;
+
+    int last = script.getLength() - 1;
+    if (last >= 0 && script[last]->kind == kind)
+    {
+        script[last]->length += length;
+        return;
+    }
+    script.insert(Edit{kind, testBegin, correctBegin, length});
+}
+
+inline int commonPrefix(const char *test, const char *correct, int length)
+{
+    return findMismatch(test, correct, length);
+}
+
+template <class Item>
+int commonPrefix(const Item *test, const Item *correct, int length)
+{
+    int i = 0;
+    while (i < length && test[i] == correct[i])
+    {
+        i++;
+    }
+    return i;
+}
+
+inline int commonSuffix(const char *test, const char *correct, int length)
+{
+    return findMismatchFromEnd(test, correct, length);
+}
+
+template <class Item>
+int commonSuffix(const Item *test, const Item *correct, int length)
+{
+    int i = 0;
+    while (i < length && test[length - i - 1] == correct[length - i - 1])
+    {
+        i++;
+    }
+    return i;
+}
+
+template <class Item>
+bool diffRange(DiffState<Item> &state, int testBegin, int testEnd, int correctBegin, int correctEnd)
+{
+    ContiguousArray<Edit> &script = *state.script;
+
+    int prefix = commonPrefix(state.test + testBegin, state.correct + correctBegin, min(testEnd - testBegin, correctEnd - correctBegin));
+    addEdit(script, EDIT_EQUAL, testBegin, correctBegin, prefix);
+    testBegin += prefix;
+    correctBegin += prefix;
+
+    int length = min(testEnd - testBegin, correctEnd - correctBegin);
+    int suffix = commonSuffix(state.test + testEnd - length, state.correct + correctEnd - length, length);
+    testEnd -= suffix;
+    correctEnd -= suffix;
+    state.work += prefix + suffix;
+
+    if (testBegin == testEnd)
+        addEdit(script, EDIT_INSERT, testBegin, correctBegin, correctEnd - correctBegin);
+    else if (correctBegin == correctEnd)
+        addEdit(script, EDIT_DELETE, testBegin, correctBegin, testEnd - testBegin);
+    else
+    {
+        // both ends now differ, so there are at least two edits and both halves are smaller than the whole
+        int x, y, u, v;
+        if (middleSnake(state, testBegin, testEnd, correctBegin, correctEnd, x, y, u, v) == -1)
+            return false;
+        if (!diffRange(state, testBegin, x, correctBegin, y))
+            return false;
+        addEdit(script, EDIT_EQUAL, x, y, u - x);
+        if (!diffRange(state, u, testEnd, v, correctEnd))
+            return false;
+    }
+
+    addEdit(script, EDIT_EQUAL, testEnd, correctEnd, suffix);
+    return true;
+}
+
+template <class Item>
+int middleSnake(DiffState<Item> &state, int testBegin, int testEnd, int correctBegin, int correctEnd, int &x, int &y, int &u, int &v)
+{
+    // finds the snake in the middle of a shortest edit path, returns the number of edits or -1 past the work limit
+    // forward[k] is the furthest x on diagonal k = x - y from the start
+    // backward[k] is the furthest distance from the end on diagonal k = (n - x) - (m - y)
+    const Item *a = state.test + testBegin;
+    const Item *b = state.correct + correctBegin;
+    int n = testEnd - testBegin;
+    int m = correctEnd - correctBegin;
+    int delta = n - m;
+    bool odd = delta & 1;
+    int *forward = state.forward.data() + state.offset;
+    int *backward = state.backward.data() + state.offset;
+    int limit = state.offset - 1;
+
+    forward[1] = 0;
+    backward[1] = 0;
+    for (int d = 0; d <= (n + m + 1) / 2; d++)
+    {
+        if (d > limit || state.work > state.maxWork)
+            return -1;
+        state.work += 2 * d + 1;
+
+        for (int k = -d; k <= d; k += 2)
+        {
+            int left = k == -d || (k != d && forward[k - 1] < forward[k + 1]) ? forward[k + 1] : forward[k - 1] + 1;
+            int top = left - k;
+            int right = left, bottom = top;
+            while (right < n && bottom < m && a[right] == b[bottom])
+            {
+                right++;
+                bottom++;
+            }
+            state.work += right - left;
+            forward[k] = right;
+
+            int c = delta - k;
+            if (odd && c >= -(d - 1) && c <= d - 1 && forward[k] + backward[c] >= n)
+            {
+                x = testBegin + left;
+                y = correctBegin + top;
+                u = testBegin + right;
+                v = correctBegin + bottom;
+                return 2 * d - 1;
+            }
+        }
+
+        for (int k = -d; k <= d; k += 2)
+        {
+            int left = k == -d || (k != d && backward[k - 1] < backward[k + 1]) ? backward[k + 1] : backward[k - 1] + 1;
+            int top = left - k;
+            int right = left, bottom = top;
+            while (right < n && bottom < m && a[n - right - 1] == b[m - bottom - 1])
+            {
+                right++;
+                bottom++;
+            }
+            state.work += right - left;
+            backward[k] = right;
+
+            int c = delta - k;
+            if (!odd && c >= -d && c <= d && backward[k] + forward[c] >= n)
+            {
+                x = testBegin + n - right;
+                y = correctBegin + m - bottom;
+                u = testBegin + n - left;
+                v = correctBegin + m - top;
+                return 2 * d;
+            }
+        }
+    }
+
+    return -1;
+}
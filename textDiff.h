@@ -0,0 +1,70 @@
+#ifndef TEXTDIFF_H
+#define TEXTDIFF_H
+
+#include <string>
+#include <vector>
+#include "array.h"
+#include "textScan.h"
+using namespace std;
+
+/*
+Myers' O(ND) diff between a test sequence and a correct sequence, used by textCompare on chars and by lineCompare on line hashes
+the middle snake is searched from both ends so memory stays linear in the length of the sequences
+equal prefixes and suffixes are stripped first, with the scanners in textScan.h for chars
+*/
+
+enum EditKind
+{
+    EDIT_EQUAL,  // in both strings
+    EDIT_DELETE, // only in the test string
+    EDIT_INSERT  // only in the correct string
+};
+
+struct Edit
+{
+    EditKind kind;
+    int testBegin;
+    int correctBegin;
+    int length;
+};
+
+// roughly the number of chars compared before a diff gives up
+const long long DEFAULT_DIFF_WORK = 1ll << 26;
+
+// fills script with a minimal edit script from test to correct, neighbouring edits of one kind are merged
+// returns false, leaving script unfinished, when the strings are too different to diff within maxWork
+bool diffText(const string &test, const string &correct, ContiguousArray<Edit> &script, long long maxWork = DEFAULT_DIFF_WORK);
+// the same for any sequence of items with ==, edit positions are item indexes
+template <class Item>
+bool diffSequence(const Item *test, int testLength, const Item *correct, int correctLength, ContiguousArray<Edit> &script, long long maxWork = DEFAULT_DIFF_WORK);
+
+// ######## helpers ########
+template <class Item>
+struct DiffState
+{
+    const Item *test;
+    const Item *correct;
+    vector<int> forward;  // furthest x on every diagonal, searching from the start
+    vector<int> backward; // the same from the end
+    int offset;           // index of diagonal 0
+    long long work;
+    long long maxWork;
+    ContiguousArray<Edit> *script;
+};
+
+void addEdit(ContiguousArray<Edit> &script, EditKind kind, int testBegin, int correctBegin, int length);
+int commonPrefix(const char *test, const char *correct, int length);
+template <class Item>
+int commonPrefix(const Item *test, const Item *correct, int length);
+// the same from the end of two ranges of length items
+int commonSuffix(const char *test, const char *correct, int length);
+template <class Item>
+int commonSuffix(const Item *test, const Item *correct, int length);
+template <class Item>
+bool diffRange(DiffState<Item> &state, int testBegin, int testEnd, int correctBegin, int correctEnd);
+template <class Item>
+int middleSnake(DiffState<Item> &state, int testBegin, int testEnd, int correctBegin, int correctEnd, int &x, int &y, int &u, int &v);
+
+#include "textDiff.cpp"
+
+#endif
@@ -0,0 +1,91 @@
+#include "textScan.h"
+
+inline size_t findMismatch(const char *lhs, const char *rhs, size_t length)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i));
+        unsigned int differ = ~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF;
+        if (differ)
+            return i + __builtin_ctz(differ);
+    }
+#endif
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t a, b;
+        memcpy(&a, lhs + i, 8);
+        memcpy(&b, rhs + i, 8);
+        if (a != b)
+            break;
+    }
+    for (; i < length; i++)
+    {
+        if (lhs[i] != rhs[i])
+            return i;
+    }
+    return length;
+}
+
+inline size_t findMismatchFromEnd(const char *lhs, const char *rhs, size_t length)
+{
+    // i counts the equal chars found so far, the block being compared ends at length - i
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + length - i - 16));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + length - i - 16));
+        unsigned int differ = ~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF;
+        if (differ)
+            return i + 15 - (31 - __builtin_clz(differ));
+    }
+#endif
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t a, b;
+        memcpy(&a, lhs + length - i - 8, 8);
+        memcpy(&b, rhs + length - i - 8, 8);
+        if (a != b)
+            break;
+    }
+    for (; i < length; i++)
+    {
+        if (lhs[length - i - 1] != rhs[length - i - 1])
+            return i;
+    }
+    return length;
+}
+
+inline size_t findMatch(const char *lhs, const char *rhs, size_t length)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i));
+        unsigned int same = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        if (same)
+            return i + __builtin_ctz(same);
+    }
+#endif
+    for (; i + 8 <= length; i += 8)
+    {
+        // a zero byte in a ^ b is a matching char
+        uint64_t a, b;
+        memcpy(&a, lhs + i, 8);
+        memcpy(&b, rhs + i, 8);
+        uint64_t x = a ^ b;
+        if ((x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull)
+            break;
+    }
+    for (; i < length; i++)
+    {
+        if (lhs[i] == rhs[i])
+            return i;
+    }
+    return length;
+}
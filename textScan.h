@@ -0,0 +1,26 @@
+#ifndef TEXTSCAN_H
+#define TEXTSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+/*
+Scans two buffers side by side for the edges of equal and unequal runs, used by textCompare
+16 bytes at a time with SSE2, 8 bytes at a time without it
+*/
+
+// first index where lhs and rhs differ, or length when they do not
+size_t findMismatch(const char *lhs, const char *rhs, size_t length);
+// number of equal chars at the end of lhs and rhs, both length long
+size_t findMismatchFromEnd(const char *lhs, const char *rhs, size_t length);
+// first index where lhs and rhs hold the same char, or length when there is none
+size_t findMatch(const char *lhs, const char *rhs, size_t length);
+
+#include "textScan.cpp"
+
+#endif